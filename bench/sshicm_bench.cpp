@@ -0,0 +1,315 @@
+// Standalone benchmark of the sshicm C++ core on synthetic data, built without R (see Makefile
+// or the sshicm_bench target of the top-level CMakeLists.txt).
+//
+// Every kernel is timed over a sweep of sample size, stratum count, category count, skew, bin
+// method and thread count, and one CSV row is written per configuration. The `value` column holds
+// the result of the timed call, so that two result files can also be diffed for changed outputs.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sshicm/sshicm.h>
+
+using namespace sshicm;
+
+struct BenchOptions {
+  std::vector<double> n = {1e3, 1e4, 1e5, 1e6};
+  std::vector<double> strata = {5, 50};
+  std::vector<double> categories = {5, 50};
+  std::vector<double> skew = {0, 1.5};
+  std::vector<std::string> bin_methods = {"Sturges", "Scott", "FreedmanDiaconis", "Rice", "SquareRoot"};
+  std::vector<double> threads;
+  std::vector<std::string> kernels = {"HistogramDensityEst", "RelEntropy", "IC_SSH", "IN_SSH",
+                                      "IC_SSHICM", "IN_SSHICM"};
+  int permutations = 99;
+  int repeats = 3;
+  double max_permutation_n = 1e6;
+  std::string output;
+};
+
+// Synthetic data set: a continuous target shifted by stratum, a nominal target that partly follows
+// the stratum, and the stratification itself; stratum and category sizes follow a Zipf law
+struct BenchData {
+  std::vector<double> d;
+  std::vector<int> d_nominal;
+  std::vector<int> s;
+};
+
+static std::vector<double> ParseNumbers(const std::string& text) {
+  std::vector<double> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    values.push_back(std::stod(item));
+  }
+  return values;
+}
+
+static std::vector<std::string> ParseStrings(const std::string& text) {
+  std::vector<std::string> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    values.push_back(item);
+  }
+  return values;
+}
+
+static void PrintUsage() {
+  std::printf(
+    "Usage: sshicm_bench [options]\n"
+    "  --n LIST                 sample sizes (default 1e3,1e4,1e5,1e6; up to 1e8)\n"
+    "  --strata LIST            stratum counts (default 5,50)\n"
+    "  --categories LIST        category counts of the nominal target (default 5,50)\n"
+    "  --skew LIST              Zipf exponents of the stratum and category sizes (default 0,1.5)\n"
+    "  --bin-methods LIST       binning methods (default all five)\n"
+    "  --threads LIST           thread counts for the permutation drivers (default 1 and all cores)\n"
+    "  --kernels LIST           kernels to run (default all)\n"
+    "  --permutations N         permutations per driver call (default 99)\n"
+    "  --repeats N              timed repetitions, the median is reported (default 3)\n"
+    "  --max-permutation-n N    largest n for the permutation drivers (default 1e6)\n"
+    "  --output FILE            write the CSV to FILE instead of stdout\n");
+}
+
+static BenchOptions ParseOptions(int argc, char** argv) {
+  BenchOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string name = argv[i];
+    if (name == "--help" || name == "-h") {
+      PrintUsage();
+      std::exit(0);
+    }
+    if (i + 1 >= argc) {
+      throw std::invalid_argument("Missing value for " + name);
+    }
+    std::string value = argv[++i];
+    if (name == "--n") {
+      options.n = ParseNumbers(value);
+    } else if (name == "--strata") {
+      options.strata = ParseNumbers(value);
+    } else if (name == "--categories") {
+      options.categories = ParseNumbers(value);
+    } else if (name == "--skew") {
+      options.skew = ParseNumbers(value);
+    } else if (name == "--bin-methods") {
+      options.bin_methods = ParseStrings(value);
+    } else if (name == "--threads") {
+      options.threads = ParseNumbers(value);
+    } else if (name == "--kernels") {
+      options.kernels = ParseStrings(value);
+    } else if (name == "--permutations") {
+      options.permutations = std::stoi(value);
+    } else if (name == "--repeats") {
+      options.repeats = std::stoi(value);
+    } else if (name == "--max-permutation-n") {
+      options.max_permutation_n = std::stod(value);
+    } else if (name == "--output") {
+      options.output = value;
+    } else {
+      throw std::invalid_argument("Unknown option " + name);
+    }
+  }
+  if (options.threads.empty()) {
+    options.threads.push_back(1);
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (cores > 1) {
+      options.threads.push_back(cores);
+    }
+  }
+  return options;
+}
+
+static std::discrete_distribution<int> ZipfDistribution(int levels, double skew) {
+  std::vector<double> weights(levels);
+  for (int k = 0; k < levels; ++k) {
+    weights[k] = 1.0 / std::pow(k + 1.0, skew);
+  }
+  return std::discrete_distribution<int>(weights.begin(), weights.end());
+}
+
+static BenchData GenerateData(size_t n, int strata, int categories, double skew) {
+  std::mt19937_64 gen(20240601);
+  std::discrete_distribution<int> stratum_dist = ZipfDistribution(strata, skew);
+  std::discrete_distribution<int> category_dist = ZipfDistribution(categories, skew);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  BenchData data;
+  data.d.resize(n);
+  data.d_nominal.resize(n);
+  data.s.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    int stratum = stratum_dist(gen);
+    data.s[i] = stratum + 1;
+    data.d[i] = noise(gen) + 0.5 * (stratum % 3);
+    data.d_nominal[i] = (unit(gen) < 0.3 ? stratum % categories : category_dist(gen)) + 1;
+  }
+  return data;
+}
+
+// Time `run` `repeats` times, returning the median and minimum seconds and the last result
+template <class Run>
+static void TimeRepeats(int repeats, Run run, double& median_seconds, double& min_seconds, double& value) {
+  std::vector<double> seconds;
+  for (int r = 0; r < repeats; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    value = run();
+    auto stop = std::chrono::steady_clock::now();
+    seconds.push_back(std::chrono::duration<double>(stop - start).count());
+  }
+  std::sort(seconds.begin(), seconds.end());
+  median_seconds = seconds[seconds.size() / 2];
+  min_seconds = seconds.front();
+}
+
+struct BenchRow {
+  std::string kernel;
+  size_t n;
+  int strata;
+  int categories;
+  double skew;
+  std::string bin_method;
+  int threads;
+  int permutations;
+};
+
+static void Report(std::FILE* out, const BenchRow& row, int repeats, double items, double median_seconds,
+                   double min_seconds, double value) {
+  std::fprintf(out, "%s,%zu,%s,%s,%g,%s,%d,%d,%d,%.6g,%.6g,%.6g,%.17g\n",
+               row.kernel.c_str(), row.n,
+               row.strata > 0 ? std::to_string(row.strata).c_str() : "NA",
+               row.categories > 0 ? std::to_string(row.categories).c_str() : "NA",
+               row.skew, row.bin_method.empty() ? "NA" : row.bin_method.c_str(),
+               row.threads, row.permutations, repeats,
+               median_seconds, min_seconds, items / median_seconds, value);
+  std::fflush(out);
+}
+
+static bool Selected(const BenchOptions& options, const std::string& kernel) {
+  return std::find(options.kernels.begin(), options.kernels.end(), kernel) != options.kernels.end();
+}
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  try {
+    options = ParseOptions(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    PrintUsage();
+    return 1;
+  }
+
+  std::FILE* out = stdout;
+  if (!options.output.empty()) {
+    out = std::fopen(options.output.c_str(), "w");
+    if (!out) {
+      std::fprintf(stderr, "Cannot open %s\n", options.output.c_str());
+      return 1;
+    }
+  }
+  std::fprintf(out, "kernel,n,strata,categories,skew,bin_method,threads,permutations,repeats,"
+                    "median_seconds,min_seconds,items_per_second,value\n");
+
+  double median_seconds = 0, min_seconds = 0, value = 0;
+  for (double n_value : options.n) {
+    size_t n = static_cast<size_t>(n_value);
+
+    // Step 1: The histogram estimator only depends on n and the bin method
+    if (Selected(options, "HistogramDensityEst")) {
+      BenchData data = GenerateData(n, 1, 1, 0);
+      for (const std::string& bin_method : options.bin_methods) {
+        TimeRepeats(options.repeats, [&]() {
+          return HistogramDensityEst(data.d, bin_method).front().second;
+        }, median_seconds, min_seconds, value);
+        Report(out, {"HistogramDensityEst", n, 0, 0, 0, bin_method, 1, 0}, options.repeats, n,
+               median_seconds, min_seconds, value);
+      }
+    }
+
+    for (double strata_value : options.strata) {
+      for (double skew : options.skew) {
+        int strata = static_cast<int>(strata_value);
+        int first_categories = static_cast<int>(options.categories.front());
+        BenchData data = GenerateData(n, strata, first_categories, skew);
+        std::vector<Span<int>> s_list(1, data.s);
+        std::vector<double> first_stratum;
+        for (size_t i = 0; i < n; ++i) {
+          if (data.s[i] == 1) {
+            first_stratum.push_back(data.d[i]);
+          }
+        }
+
+        // Step 2: Kernels on the continuous target, for every bin method
+        for (const std::string& bin_method : options.bin_methods) {
+          if (Selected(options, "RelEntropy")) {
+            TimeRepeats(options.repeats, [&]() {
+              return RelEntropy(first_stratum, data.d, bin_method);
+            }, median_seconds, min_seconds, value);
+            Report(out, {"RelEntropy", n, strata, 0, skew, bin_method, 1, 0}, options.repeats, n,
+                   median_seconds, min_seconds, value);
+          }
+          if (Selected(options, "IC_SSH")) {
+            TimeRepeats(options.repeats, [&]() {
+              return IC_SSH(data.d, data.s, bin_method);
+            }, median_seconds, min_seconds, value);
+            Report(out, {"IC_SSH", n, strata, 0, skew, bin_method, 1, 0}, options.repeats, n,
+                   median_seconds, min_seconds, value);
+          }
+          if (Selected(options, "IC_SSHICM") && n_value <= options.max_permutation_n) {
+            for (double threads : options.threads) {
+              TimeRepeats(options.repeats, [&]() {
+                std::vector<double> result = IC_SSHICM_Batch(data.d, s_list, 42, options.permutations, bin_method,
+                                                              false, 10, 0.05, static_cast<int>(threads))[0];
+                return result[0] + result[1];
+              }, median_seconds, min_seconds, value);
+              Report(out, {"IC_SSHICM", n, strata, 0, skew, bin_method, static_cast<int>(threads), options.permutations},
+                     options.repeats, static_cast<double>(n) * options.permutations, median_seconds, min_seconds, value);
+            }
+          }
+        }
+
+        // Step 3: Kernels on the nominal target, for every category count
+        for (double categories_value : options.categories) {
+          int categories = static_cast<int>(categories_value);
+          BenchData other;
+          if (categories != first_categories) {
+            other = GenerateData(n, strata, categories, skew);
+          }
+          const BenchData& nominal = categories == first_categories ? data : other;
+          if (Selected(options, "IN_SSH")) {
+            TimeRepeats(options.repeats, [&]() {
+              return IN_SSH(nominal.d_nominal, nominal.s);
+            }, median_seconds, min_seconds, value);
+            Report(out, {"IN_SSH", n, strata, categories, skew, "", 1, 0}, options.repeats, n,
+                   median_seconds, min_seconds, value);
+          }
+          if (Selected(options, "IN_SSHICM") && n_value <= options.max_permutation_n) {
+            std::vector<Span<int>> nominal_s_list(1, nominal.s);
+            for (double threads : options.threads) {
+              TimeRepeats(options.repeats, [&]() {
+                std::vector<double> result = IN_SSHICM_Batch(nominal.d_nominal, nominal_s_list, 42, options.permutations,
+                                                              false, 10, 0.05, static_cast<int>(threads))[0];
+                return result[0] + result[1];
+              }, median_seconds, min_seconds, value);
+              Report(out, {"IN_SSHICM", n, strata, categories, skew, "", static_cast<int>(threads), options.permutations},
+                     options.repeats, static_cast<double>(n) * options.permutations, median_seconds, min_seconds, value);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return 0;
+}
@@ -0,0 +1,141 @@
+#ifndef AsymptoticTest_H
+#define AsymptoticTest_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+namespace sshicm {
+
+// How the p-value of IN_SSH is obtained: from permutations, from the asymptotic chi-square
+// distribution of the G statistic 2 * n * MI under independence, or asymptotically where the
+// expected cell counts allow it (CochranRuleHolds) and from permutations elsewhere
+enum PValueMethod {
+  kPValuePermutation,
+  kPValueAsymptotic,
+  kPValueAuto
+};
+
+// P-value method named by pvalue
+inline PValueMethod ParsePValueMethod(const std::string& method) {
+  if (method == "permutation") {
+    return kPValuePermutation;
+  } else if (method == "asymptotic") {
+    return kPValueAsymptotic;
+  } else if (method == "auto") {
+    return kPValueAuto;
+  } else {
+    throw std::invalid_argument("Unknown p-value method.");
+  }
+}
+
+// Regularized upper incomplete gamma function Q(a, x) = Gamma(a, x) / Gamma(a), by its series for
+// x < a + 1 and by its continued fraction (modified Lentz) otherwise, so that small tail
+// probabilities keep their relative precision
+inline double RegularizedGammaQ(double a, double x) {
+  if (!(a > 0) || !(x >= 0)) {
+    throw std::invalid_argument("Incomplete gamma function needs a > 0 and x >= 0.");
+  }
+  if (x == 0) {
+    return 1.0;
+  }
+  const double epsilon = 1e-15;
+  const int max_iterations = 100000;
+  double log_prefactor = a * std::log(x) - x - std::lgamma(a);
+
+  if (x < a + 1) {
+    double term = 1.0 / a;
+    double sum = term;
+    for (int n = 1; n < max_iterations; ++n) {
+      term *= x / (a + n);
+      sum += term;
+      if (std::fabs(term) < std::fabs(sum) * epsilon) {
+        break;
+      }
+    }
+    return std::max(0.0, 1.0 - sum * std::exp(log_prefactor));
+  }
+
+  const double tiny = 1e-300;
+  double b = x + 1.0 - a;
+  double c = 1.0 / tiny;
+  double d = 1.0 / b;
+  double h = d;
+  for (int n = 1; n < max_iterations; ++n) {
+    double an = -n * (n - a);
+    b += 2.0;
+    d = an * d + b;
+    if (std::fabs(d) < tiny) {
+      d = tiny;
+    }
+    c = b + an / c;
+    if (std::fabs(c) < tiny) {
+      c = tiny;
+    }
+    d = 1.0 / d;
+    double delta = d * c;
+    h *= delta;
+    if (std::fabs(delta - 1.0) < epsilon) {
+      break;
+    }
+  }
+  return std::exp(log_prefactor) * h;
+}
+
+// Probability that a chi-square variable with df degrees of freedom is at least statistic; with no
+// degrees of freedom the statistic is 0 and the p-value is 1
+inline double ChiSquareUpperTail(double statistic, double df) {
+  if (!(df > 0) || !(statistic > 0)) {
+    return 1.0;
+  }
+  return RegularizedGammaQ(df / 2, statistic / 2);
+}
+
+// Cochran's rule for a contingency table with the given non-zero row and column sums: every
+// expected count r * c / n is at least 1, and at most 20% of them are below 5. The cells below 5
+// are counted per row by binary search over the sorted column sums, in O(K log L)
+inline bool CochranRuleHolds(std::vector<int64_t> row_sums, std::vector<int64_t> column_sums, double total_count) {
+  if (row_sums.empty() || column_sums.empty()) {
+    return false;
+  }
+  std::sort(row_sums.begin(), row_sums.end());
+  std::sort(column_sums.begin(), column_sums.end());
+  if (static_cast<double>(row_sums.front()) * column_sums.front() < total_count) {
+    return false;
+  }
+  double small_cells = 0.0;
+  for (int64_t row_sum : row_sums) {
+    small_cells += std::partition_point(column_sums.begin(), column_sums.end(), [&](int64_t column_sum) {
+      return static_cast<double>(row_sum) * column_sum < 5.0 * total_count;
+    }) - column_sums.begin();
+  }
+  return small_cells <= 0.2 * static_cast<double>(row_sums.size()) * column_sums.size();
+}
+
+// Asymptotic G-test of independence of a contingency table
+struct GTestResult {
+  double statistic;            // G = 2 * sum O * ln(O / E) = 2 * n * MI, MI in nats
+  double df;                   // (K - 1) * (L - 1) over the non-empty rows and columns
+  double p_value;
+  bool expected_counts_valid;  // Cochran's rule holds, so the chi-square approximation is reliable
+};
+
+// G-test from the G statistic and the non-zero row and column sums of its table
+inline GTestResult GTestFromMargins(double statistic,
+                                    const std::vector<int64_t>& row_sums,
+                                    const std::vector<int64_t>& column_sums,
+                                    double total_count) {
+  GTestResult result;
+  result.statistic = std::max(statistic, 0.0);
+  result.df = (static_cast<double>(row_sums.size()) - 1) * (static_cast<double>(column_sums.size()) - 1);
+  result.p_value = ChiSquareUpperTail(result.statistic, result.df);
+  result.expected_counts_valid = CochranRuleHolds(row_sums, column_sums, total_count);
+  return result;
+}
+
+} // namespace sshicm
+
+#endif // AsymptoticTest_H
@@ -0,0 +1,171 @@
+#ifndef BinningRule_H
+#define BinningRule_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "Span.h"
+
+namespace sshicm {
+
+// Histogram binning methods accepted as bin_method
+enum BinningMethod {
+  kBinSturges,
+  kBinSquareRoot,
+  kBinRice,
+  kBinScott,
+  kBinFreedmanDiaconis
+};
+
+// Binning method named by bin_method; this is the only place where the name is compared
+inline BinningMethod ParseBinningMethod(const std::string& method) {
+  if (method == "SquareRoot") {
+    return kBinSquareRoot;
+  } else if (method == "Sturges") {
+    return kBinSturges;
+  } else if (method == "Rice") {
+    return kBinRice;
+  } else if (method == "Scott") {
+    return kBinScott;
+  } else if (method == "FreedmanDiaconis") {
+    return kBinFreedmanDiaconis;
+  } else {
+    throw std::invalid_argument("Unknown binning method.");
+  }
+}
+
+// Number of bins of the given width covering range, with a single bin when the width collapses to zero
+inline int BinsFromWidth(double range, double bin_width) {
+  if (!(bin_width > 0)) {
+    return 1;
+  }
+  return static_cast<int>(std::ceil(range / bin_width));
+}
+
+// Bin count of the rules that only depend on the sample size, or 0 for the rules that need the data
+inline int CalculateBinsFromSize(size_t n, BinningMethod method) {
+  switch (method) {
+  case kBinSquareRoot:
+    return static_cast<int>(std::ceil(std::sqrt(n)));
+  case kBinSturges:
+    return static_cast<int>(std::ceil(std::log2(n) + 1));
+  case kBinRice:
+    return static_cast<int>(std::ceil(2 * std::cbrt(n)));
+  default:
+    return 0;
+  }
+}
+
+// Values sorted in ascending order, with the statistics that binning rules read off them. When a
+// rule needs moments, prefix sums of (value - shift) and of its square are kept, so the mean and
+// variance of any run of values cost O(1); shifting by the middle value keeps the prefix sums small
+struct SortedData {
+  Span<double> values;
+  double shift;
+  std::vector<double> prefix_sum;
+  std::vector<double> prefix_square_sum;
+
+  SortedData() : shift(0.0) {}
+  explicit SortedData(Span<double> sorted_values, bool with_moments = false)
+    : values(sorted_values), shift(0.0) {
+    if (with_moments && !values.empty()) {
+      shift = values[values.size() / 2];
+      prefix_sum.assign(values.size() + 1, 0.0);
+      prefix_square_sum.assign(values.size() + 1, 0.0);
+      for (size_t i = 0; i < values.size(); ++i) {
+        double centered = values[i] - shift;
+        prefix_sum[i + 1] = prefix_sum[i] + centered;
+        prefix_square_sum[i + 1] = prefix_square_sum[i] + centered * centered;
+      }
+    }
+  }
+
+  bool has_moments() const { return !prefix_sum.empty(); }
+};
+
+// Binning rules as compile-time policies. Each rule gives the bin count of the sorted values
+// values[first, last), n = last - first >= 2, and declares in kNeedsMoments whether the pipeline
+// has to prepare prefix sums for it; rules that only need n or the quartiles read nothing else
+struct SturgesRule {
+  static const BinningMethod kMethod = kBinSturges;
+  static const bool kNeedsMoments = false;
+  static int Bins(const SortedData&, size_t first, size_t last) {
+    return static_cast<int>(std::ceil(std::log2(last - first) + 1));
+  }
+};
+
+struct SquareRootRule {
+  static const BinningMethod kMethod = kBinSquareRoot;
+  static const bool kNeedsMoments = false;
+  static int Bins(const SortedData&, size_t first, size_t last) {
+    return static_cast<int>(std::ceil(std::sqrt(last - first)));
+  }
+};
+
+struct RiceRule {
+  static const BinningMethod kMethod = kBinRice;
+  static const bool kNeedsMoments = false;
+  static int Bins(const SortedData&, size_t first, size_t last) {
+    return static_cast<int>(std::ceil(2 * std::cbrt(last - first)));
+  }
+};
+
+struct ScottRule {
+  static const BinningMethod kMethod = kBinScott;
+  static const bool kNeedsMoments = true;
+  static int Bins(const SortedData& data, size_t first, size_t last) {
+    size_t n = last - first;
+    double variance;
+    if (data.has_moments()) {
+      // Moments of the shifted values, which have the same variance
+      double mean = (data.prefix_sum[last] - data.prefix_sum[first]) / n;
+      variance = (data.prefix_square_sum[last] - data.prefix_square_sum[first]) / n - mean * mean;
+      variance = std::max(variance, 0.0);
+    } else {
+      const double* begin = data.values.data() + first;
+      const double* end = data.values.data() + last;
+      double mean = std::accumulate(begin, end, 0.0) / n;
+      variance = std::inner_product(begin, end, begin, 0.0) / n - mean * mean;
+    }
+    double bin_width = 3.49 * std::sqrt(variance) / std::cbrt(n);
+    return BinsFromWidth(data.values[last - 1] - data.values[first], bin_width);
+  }
+};
+
+struct FreedmanDiaconisRule {
+  static const BinningMethod kMethod = kBinFreedmanDiaconis;
+  static const bool kNeedsMoments = false;
+  static int Bins(const SortedData& data, size_t first, size_t last) {
+    // The data are already sorted, so the quartiles are read off directly
+    size_t n = last - first;
+    const double* values = data.values.data() + first;
+    double iqr = values[3 * n / 4] - values[n / 4];
+    double bin_width = 2 * iqr / std::cbrt(n);
+    return BinsFromWidth(values[n - 1] - values[0], bin_width);
+  }
+};
+
+// Bin count of values[first, last) by the rule of method, for callers outside the specialized
+// pipeline
+inline int BinsByMethod(BinningMethod method, const SortedData& data, size_t first, size_t last) {
+  switch (method) {
+  case kBinSturges:
+    return SturgesRule::Bins(data, first, last);
+  case kBinSquareRoot:
+    return SquareRootRule::Bins(data, first, last);
+  case kBinRice:
+    return RiceRule::Bins(data, first, last);
+  case kBinScott:
+    return ScottRule::Bins(data, first, last);
+  default:
+    return FreedmanDiaconisRule::Bins(data, first, last);
+  }
+}
+
+} // namespace sshicm
+
+#endif // BinningRule_H
@@ -0,0 +1,269 @@
+#ifndef Breakpoints_H
+#define Breakpoints_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "Span.h"
+#include "BinningRule.h"
+#include "RelEntropy.h"
+#include "Workspace.h"
+#include "ParallelFor.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+
+namespace sshicm {
+
+// Optimal breakpoints of a continuous factor x for IC or IN. Both measures are sums of one term per
+// stratum that only depends on the rows of that stratum, so over strata that are intervals of x the
+// best scheme with strata_number strata follows by dynamic programming from the terms of all
+// intervals (Fisher's optimal partition). Candidate cuts lie between distinct values of x; when
+// there are more than max_candidates of them, the sorted rows are first grouped into atoms of about
+// equal size and strata are unions of consecutive atoms. With m atoms, the m (m + 1) / 2 interval
+// terms are computed once, after which every scheme, and every move of one breakpoint, costs table
+// lookups only. For IN a term follows from prefix counts in O(L). For IC only the gathering of the
+// d values is incremental (an interval is the previous one extended by one atom): the bins of a
+// term depend on the range of its interval, so its histograms are counted again in full, and the
+// terms cost O(m^2 n) in total.
+
+// Breakpoints found for x: the largest x of every stratum but the last, so that x <= breaks[0] is
+// stratum 1, breaks[0] < x <= breaks[1] stratum 2, and so on, together with the measure of the
+// scheme and the stratum (1..strata_number) of every row
+struct BreakpointResult {
+  std::vector<double> breaks;
+  double value;
+  std::vector<int> strata;
+};
+
+// Order of the rows by x, and the end (in that order) of each atom; atoms only end between
+// distinct values of x and hold about n / max_candidates rows each
+inline std::vector<size_t> BreakpointAtoms(Span<double> x, int max_candidates, std::vector<int>& order) {
+  size_t n = x.size();
+  order.resize(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return x[a] < x[b]; });
+
+  std::vector<size_t> atom_ends;
+  double target_size = static_cast<double>(n) / std::max(1, max_candidates);
+  size_t atom_begin = 0;
+  for (size_t i = 1; i <= n; ++i) {
+    bool value_ends = i == n || x[order[i]] != x[order[i - 1]];
+    if (value_ends && (i == n || i - atom_begin >= target_size)) {
+      atom_ends.push_back(i);
+      atom_begin = i;
+    }
+  }
+  return atom_ends;
+}
+
+// Best split of m atoms into strata_number consecutive intervals, maximizing the sum of
+// gain[a * (m + 1) + b] over the intervals [a, b) of atoms; invalid intervals hold -infinity.
+// Returns the atom index where each stratum but the first begins
+inline std::vector<size_t> OptimalPartition(const std::vector<double>& gain, size_t m, int strata_number) {
+  const double invalid = -std::numeric_limits<double>::infinity();
+  size_t K = static_cast<size_t>(strata_number);
+  std::vector<double> best((K + 1) * (m + 1), invalid);
+  std::vector<size_t> previous((K + 1) * (m + 1), 0);
+  best[0] = 0.0;
+  for (size_t k = 1; k <= K; ++k) {
+    for (size_t b = k; b <= m; ++b) {
+      for (size_t a = k - 1; a < b; ++a) {
+        double candidate = best[(k - 1) * (m + 1) + a] + gain[a * (m + 1) + b];
+        if (candidate > best[k * (m + 1) + b]) {
+          best[k * (m + 1) + b] = candidate;
+          previous[k * (m + 1) + b] = a;
+        }
+      }
+    }
+  }
+  if (best[K * (m + 1) + m] == invalid) {
+    throw std::invalid_argument("No stratification into the requested number of strata with the minimum stratum size.");
+  }
+
+  std::vector<size_t> starts(K - 1);
+  size_t b = m;
+  for (size_t k = K; k > 1; --k) {
+    b = previous[k * (m + 1) + b];
+    starts[k - 2] = b;
+  }
+  return starts;
+}
+
+// Breaks and row strata of the scheme whose strata begin at the given atoms
+inline BreakpointResult BreakpointScheme(Span<double> x,
+                                         const std::vector<int>& order,
+                                         const std::vector<size_t>& atom_ends,
+                                         const std::vector<size_t>& starts) {
+  BreakpointResult result;
+  result.value = 0.0;
+  result.strata.assign(x.size(), 0);
+  size_t row_begin = 0;
+  for (size_t k = 0; k <= starts.size(); ++k) {
+    size_t row_end = k < starts.size() ? atom_ends[starts[k] - 1] : x.size();
+    for (size_t i = row_begin; i < row_end; ++i) {
+      result.strata[order[i]] = static_cast<int>(k) + 1;
+    }
+    if (k < starts.size()) {
+      result.breaks.push_back(x[order[row_end - 1]]);
+    }
+    row_begin = row_end;
+  }
+  return result;
+}
+
+// Check the arguments shared by the breakpoint searches and group x into atoms
+inline std::vector<size_t> PrepareBreakpoints(size_t d_size,
+                                              Span<double> x,
+                                              int strata_number,
+                                              int max_candidates,
+                                              std::vector<int>& order) {
+  if (x.size() != d_size) {
+    throw std::invalid_argument("Vectors x and d must have the same length.");
+  }
+  if (strata_number < 1) {
+    throw std::invalid_argument("Number of strata must be positive.");
+  }
+  std::vector<size_t> atom_ends = BreakpointAtoms(x, std::max(max_candidates, strata_number), order);
+  if (atom_ends.size() < static_cast<size_t>(strata_number)) {
+    throw std::invalid_argument("x has fewer distinct values than the requested number of strata.");
+  }
+  return atom_ends;
+}
+
+// IN_SSH_Breakpoints: breakpoints of x into strata_number strata that maximize IN_SSH of d. IN_SSH
+// is 1 - H(d | s) / H(d) and H(d | s) sums (n_k / n) H(d | stratum k) over the strata, so each
+// interval term comes from the prefix counts of the categories of d over the atoms
+inline BreakpointResult IN_SSH_Breakpoints(Span<int> d,
+                                           Span<double> x,
+                                           int strata_number,
+                                           int max_candidates = 100,
+                                           int min_size = 1,
+                                           int threads = 0) {
+  std::vector<int> order;
+  std::vector<size_t> atom_ends = PrepareBreakpoints(d.size(), x, strata_number, max_candidates, order);
+  size_t m = atom_ends.size();
+  double total_count = d.size();
+
+  // Step 1: Prefix counts of the categories of d over the atoms, in a flat (m + 1) x L table
+  int d_levels = 0;
+  std::vector<int> d_codes = ComputeDenseCodes(d, d_levels);
+  size_t L = static_cast<size_t>(d_levels);
+  std::vector<int> prefix((m + 1) * L, 0);
+  size_t row = 0;
+  for (size_t a = 0; a < m; ++a) {
+    std::copy(prefix.begin() + a * L, prefix.begin() + (a + 1) * L, prefix.begin() + (a + 1) * L);
+    for (; row < atom_ends[a]; ++row) {
+      prefix[(a + 1) * L + d_codes[order[row]] - 1]++;
+    }
+  }
+
+  // Step 2: Gain of every interval of atoms: minus its share of the conditional entropy
+  const double invalid = -std::numeric_limits<double>::infinity();
+  std::vector<double> gain((m + 1) * (m + 1), invalid);
+  ParallelFor(0, static_cast<int>(m), [&](size_t a) {
+    size_t row_begin = a > 0 ? atom_ends[a - 1] : 0;
+    for (size_t b = a + 1; b <= m; ++b) {
+      size_t stratum_size = atom_ends[b - 1] - row_begin;
+      if (stratum_size < static_cast<size_t>(std::max(min_size, 1))) {
+        continue;
+      }
+      double conditional_entropy = 0.0;
+      for (size_t l = 0; l < L; ++l) {
+        int count = prefix[b * L + l] - prefix[a * L + l];
+        if (count > 0) {
+          double x_probability = static_cast<double>(count) / stratum_size;
+          conditional_entropy -= x_probability * std::log2(x_probability);
+        }
+      }
+      gain[a * (m + 1) + b] = -(stratum_size / total_count) * conditional_entropy;
+    }
+  }, threads);
+
+  // Step 3: Best scheme, with IN_SSH recomputed on its strata
+  BreakpointResult result = BreakpointScheme(x, order, atom_ends, OptimalPartition(gain, m, strata_number));
+  result.value = IN_SSH(d, result.strata);
+  return result;
+}
+
+// Gains of every interval of atoms for IC_SSH with the binning rule `Rule`: the weighted term
+// p_k * atan(RelEntropy) / (pi / 2) of the interval as a stratum. The d values of each interval are
+// the previous interval's extended by one atom, but RelEntropy is evaluated on the whole interval,
+// in O(n_interval + bins), since its bins follow from the interval's range
+template <class Rule>
+std::vector<double> IC_SSH_BreakpointGains(Span<double> d,
+                                           const std::vector<int>& order,
+                                           const std::vector<size_t>& atom_ends,
+                                           int min_size,
+                                           int threads) {
+  size_t m = atom_ends.size();
+  std::vector<double> sorted_values(d.begin(), d.end());
+  std::sort(sorted_values.begin(), sorted_values.end());
+  SortedData sorted_d(sorted_values, Rule::kNeedsMoments);
+
+  const double invalid = -std::numeric_limits<double>::infinity();
+  std::vector<double> gain((m + 1) * (m + 1), invalid);
+  ParallelFor(0, static_cast<int>(m), [&](size_t a) {
+    RelEntropyWorkspace workspace;
+    std::vector<double> stratum_values;
+    size_t row = a > 0 ? atom_ends[a - 1] : 0;
+    for (size_t b = a + 1; b <= m; ++b) {
+      for (; row < atom_ends[b - 1]; ++row) {
+        stratum_values.push_back(d[order[row]]);
+      }
+      if (stratum_values.size() < static_cast<size_t>(std::max(min_size, 2))) {
+        continue;
+      }
+      double rel_entropy = RelEntropySortedRule<Rule>(stratum_values, sorted_d, workspace);
+      double probability = static_cast<double>(stratum_values.size()) / d.size();
+      gain[a * (m + 1) + b] = probability * (std::atan(rel_entropy) / (M_PI / 2));
+    }
+  }, threads);
+  return gain;
+}
+
+// IC_SSH_Breakpoints: breakpoints of x into strata_number strata that maximize IC_SSH of d. Strata
+// need at least two rows (and min_size) for their densities
+inline BreakpointResult IC_SSH_Breakpoints(Span<double> d,
+                                           Span<double> x,
+                                           int strata_number,
+                                           const std::string& bin_method = "Sturges",
+                                           int max_candidates = 100,
+                                           int min_size = 2,
+                                           int threads = 0) {
+  std::vector<int> order;
+  std::vector<size_t> atom_ends = PrepareBreakpoints(d.size(), x, strata_number, max_candidates, order);
+
+  // Step 1: Gain of every interval of atoms, with the kernel of the binning rule
+  std::vector<double> gain;
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    gain = IC_SSH_BreakpointGains<SturgesRule>(d, order, atom_ends, min_size, threads);
+    break;
+  case kBinSquareRoot:
+    gain = IC_SSH_BreakpointGains<SquareRootRule>(d, order, atom_ends, min_size, threads);
+    break;
+  case kBinRice:
+    gain = IC_SSH_BreakpointGains<RiceRule>(d, order, atom_ends, min_size, threads);
+    break;
+  case kBinScott:
+    gain = IC_SSH_BreakpointGains<ScottRule>(d, order, atom_ends, min_size, threads);
+    break;
+  default:
+    gain = IC_SSH_BreakpointGains<FreedmanDiaconisRule>(d, order, atom_ends, min_size, threads);
+    break;
+  }
+
+  // Step 2: Best scheme, with IC_SSH recomputed on its strata
+  BreakpointResult result = BreakpointScheme(x, order, atom_ends,
+                                             OptimalPartition(gain, atom_ends.size(), strata_number));
+  result.value = IC_SSH(d, result.strata, bin_method);
+  return result;
+}
+
+} // namespace sshicm
+
+#endif // Breakpoints_H
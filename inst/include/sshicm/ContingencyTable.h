@@ -0,0 +1,150 @@
+#ifndef ContingencyTable_H
+#define ContingencyTable_H
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include "Span.h"
+#include "IN_SSH.h"
+
+namespace sshicm {
+
+// Joint counts of (s, d) over part of a data set, e.g. one shard of a data set partitioned by
+// region. Tables of different parts merge by adding their counts, in any order and grouping, so
+// IN_SSH of the whole data set can be computed from the merged table without the rows; a table
+// only holds the non-zero cells, so it is at most K x L in size for K strata and L categories.
+// The codes of d and s must mean the same values in every part.
+class ContingencyTable {
+public:
+  ContingencyTable() : total_count_(0) {}
+
+  // Count the rows of d and s, with the joint frequencies of ComputeJointFrequency
+  void Add(Span<int> d, Span<int> s) {
+    if (d.size() != s.size()) {
+      throw std::invalid_argument("Vectors d and s must have the same length.");
+    }
+    for (const auto& cell : ComputeJointFrequency(d, s)) {
+      joint_frequency_[cell.first] += cell.second;
+    }
+    total_count_ += d.size();
+  }
+
+  // Add `count` rows with stratum s_value and category d_value
+  void AddCount(int d_value, int s_value, int64_t count) {
+    if (count < 0) {
+      throw std::invalid_argument("Counts must not be negative.");
+    }
+    if (count > 0) {
+      joint_frequency_[std::make_pair(s_value, d_value)] += count;
+      total_count_ += count;
+    }
+  }
+
+  void Merge(const ContingencyTable& other) {
+    for (const auto& cell : other.joint_frequency_) {
+      joint_frequency_[cell.first] += cell.second;
+    }
+    total_count_ += other.total_count_;
+  }
+
+  int64_t total_count() const { return total_count_; }
+  size_t cell_number() const { return joint_frequency_.size(); }
+
+  // Non-zero counts keyed by (s, d), in ascending order of s and then of d
+  const std::map<std::pair<int, int>, int64_t>& joint_frequency() const { return joint_frequency_; }
+
+  // Portable binary form: the tag "SCT1", the cell count as 8 bytes, then 4 bytes of s, 4 bytes
+  // of d and 8 bytes of count per cell, all little-endian
+  std::string Serialize() const {
+    std::string bytes("SCT1");
+    bytes.reserve(12 + joint_frequency_.size() * 16);
+    PutBytes(bytes, joint_frequency_.size(), 8);
+    for (const auto& cell : joint_frequency_) {
+      PutBytes(bytes, static_cast<uint32_t>(cell.first.first), 4);
+      PutBytes(bytes, static_cast<uint32_t>(cell.first.second), 4);
+      PutBytes(bytes, static_cast<uint64_t>(cell.second), 8);
+    }
+    return bytes;
+  }
+
+  static ContingencyTable Deserialize(const std::string& bytes) {
+    if (bytes.size() < 12 || bytes.compare(0, 4, "SCT1") != 0) {
+      throw std::invalid_argument("Not a serialized contingency table.");
+    }
+    uint64_t cell_number = GetBytes(bytes, 4, 8);
+    if ((bytes.size() - 12) / 16 != cell_number || (bytes.size() - 12) % 16 != 0) {
+      throw std::invalid_argument("Serialized contingency table has the wrong size.");
+    }
+    ContingencyTable table;
+    for (uint64_t i = 0; i < cell_number; ++i) {
+      size_t offset = 12 + i * 16;
+      int s_value = static_cast<int32_t>(GetBytes(bytes, offset, 4));
+      int d_value = static_cast<int32_t>(GetBytes(bytes, offset + 4, 4));
+      table.AddCount(d_value, s_value, static_cast<int64_t>(GetBytes(bytes, offset + 8, 8)));
+    }
+    return table;
+  }
+
+private:
+  static void PutBytes(std::string& bytes, uint64_t value, int width) {
+    for (int i = 0; i < width; ++i) {
+      bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+
+  static uint64_t GetBytes(const std::string& bytes, size_t offset, int width) {
+    uint64_t value = 0;
+    for (int i = 0; i < width; ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+  }
+
+  std::map<std::pair<int, int>, int64_t> joint_frequency_;
+  int64_t total_count_;
+};
+
+// Function to compute IN_SSH from a contingency table. The terms are added in the order that
+// IN_SSH adds them on the rows, so the two agree for the same counts
+inline double IN_SSH_Table(const ContingencyTable& table) {
+  double total_count = static_cast<double>(table.total_count());
+  if (!(total_count > 0)) {
+    throw std::invalid_argument("The contingency table is empty.");
+  }
+
+  // Step 1: Derive both marginals from the joint counts
+  std::map<int, int64_t> d_frequency;
+  std::map<int, int64_t> s_frequency;
+  for (const auto& cell : table.joint_frequency()) {
+    s_frequency[cell.first.first] += cell.second;
+    d_frequency[cell.first.second] += cell.second;
+  }
+
+  // Step 2: Compute entropy of d
+  std::map<int, double> d_probability;
+  for (const auto& pair : d_frequency) {
+    d_probability[pair.first] = static_cast<double>(pair.second) / total_count;
+  }
+  double I_d = ComputeEntropy(d_probability);
+
+  // Step 3: Compute conditional entropy of d given s in one pass over the cells, which come in
+  // ascending order of s and then of d as in ComputeConditionalEntropy
+  double I_d_given_s = 0.0;
+  for (const auto& cell : table.joint_frequency()) {
+    double s_probability = static_cast<double>(s_frequency[cell.first.first]) / total_count;
+    double x_probability = (static_cast<double>(cell.second) / total_count) / s_probability;
+    if (x_probability > 0) {
+      I_d_given_s -= s_probability * x_probability * std::log2(x_probability);
+    }
+  }
+
+  // Step 4: Compute IN_SSH
+  return 1.0 - (I_d_given_s / I_d);
+}
+
+} // namespace sshicm
+
+#endif // ContingencyTable_H
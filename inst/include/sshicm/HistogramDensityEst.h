@@ -0,0 +1,171 @@
+#ifndef HistogramDensityEst_H
+#define HistogramDensityEst_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include "HistogramKernels.h"
+#include "BinningRule.h"
+#include "Span.h"
+
+namespace sshicm {
+
+// Bin index of a value on `bins` equal-width bins starting at min_val, with max_val folded into the last bin
+inline int HistogramBinIndex(double value, double min_val, double bin_width, int bins) {
+  int bin_index = static_cast<int>((value - min_val) / bin_width);
+  return bin_index < bins ? bin_index : bins - 1;
+}
+
+// Bin count of the rules that only depend on the sample size, or 0 for the rules that need the data
+inline int CalculateBinsFromSize(size_t n, const std::string& method) {
+  return CalculateBinsFromSize(n, ParseBinningMethod(method));
+}
+
+// Compute bin width or bin count based on different methods, for data sorted in [first, last)
+inline int CalculateBinsSorted(const double* first, const double* last, const std::string& method) {
+  size_t n = last - first;
+  if (n < 2) {
+    throw std::invalid_argument("Data size must be at least 2.");
+  }
+  return BinsByMethod(ParseBinningMethod(method), SortedData(Span<double>(first, n)), 0, n);
+}
+
+// Compute bin width or bin count based on different methods, for unsorted data spanning range
+inline int CalculateBinsUnsorted(const std::vector<double>& data, double range, const std::string& method) {
+  size_t n = data.size();
+  if (n < 2) {
+    throw std::invalid_argument("Data size must be at least 2.");
+  }
+  BinningMethod rule = ParseBinningMethod(method);
+  int bins = CalculateBinsFromSize(n, rule);
+  if (bins > 0) {
+    return bins;
+  }
+
+  if (rule == kBinScott) {
+    double mean = std::accumulate(data.begin(), data.end(), 0.0) / n;
+    double variance = std::inner_product(data.begin(), data.end(), data.begin(), 0.0) / n - mean * mean;
+    double bin_width = 3.49 * std::sqrt(variance) / std::cbrt(n);
+    return BinsFromWidth(range, bin_width);
+  } else {
+    // Only the two quartiles are needed, which nth_element finds without a full sort
+    std::vector<double> partitioned = data;
+    std::nth_element(partitioned.begin(), partitioned.begin() + 3 * n / 4, partitioned.end());
+    double q3 = partitioned[3 * n / 4];
+    std::nth_element(partitioned.begin(), partitioned.begin() + n / 4, partitioned.begin() + 3 * n / 4);
+    double q1 = partitioned[n / 4];
+    double bin_width = 2 * (q3 - q1) / std::cbrt(n);
+    return BinsFromWidth(range, bin_width);
+  }
+}
+
+// Compute bin width or bin count based on different methods
+inline int CalculateBins(const std::vector<double>& data, const std::string& method) {
+  return CalculateBinsSorted(data.data(), data.data() + data.size(), method);
+}
+
+// Count sorted data in [first, last) into counts[0, bins) by locating each bin boundary with a
+// binary search, so the cost is O(bins * log n) instead of one pass over the data
+inline void HistogramCountsSorted(const double* first, const double* last,
+                                  double min_val, double bin_width, int bins,
+                                  int* counts) {
+  const double* bin_begin = first;
+  for (int i = 0; i < bins - 1; ++i) {
+    const double* bin_end = std::partition_point(bin_begin, last, [&](double value) {
+      return HistogramBinIndex(value, min_val, bin_width, bins) <= i;
+    });
+    counts[i] = static_cast<int>(bin_end - bin_begin);
+    bin_begin = bin_end;
+  }
+  counts[bins - 1] = static_cast<int>(last - bin_begin);
+}
+
+// Count sorted data in [first, last) into equal-width bins
+inline std::vector<int> HistogramCountsSorted(const double* first, const double* last,
+                                              double min_val, double bin_width, int bins) {
+  std::vector<int> counts(bins, 0);
+  HistogramCountsSorted(first, last, min_val, bin_width, bins, counts.data());
+  return counts;
+}
+
+// Histogram-based density estimation
+inline std::vector<std::pair<double, double>> HistogramDensityEst(const std::vector<double>& data,
+                                                                  const std::string& bin_method) {
+  size_t n = data.size();
+  if (n < 2) {
+    throw std::invalid_argument("Data size must be at least 2.");
+  }
+
+  // Compute the range without sorting
+  double min_val, max_val;
+  HistogramMinMax(data.data(), n, min_val, max_val);
+  if (!(max_val > min_val)) {
+    throw std::invalid_argument("Data range must be positive.");
+  }
+
+  // Calculate bins and bin width
+  int bins = CalculateBinsUnsorted(data, max_val - min_val, bin_method);
+  double bin_width = (max_val - min_val) / bins;
+
+  // Count data points in each bin by direct indexing
+  std::vector<int> counts(bins, 0);
+  HistogramCountUniform(data.data(), n, min_val, bin_width, bins, counts.data());
+
+  // Compute density
+  std::vector<std::pair<double, double>> density;
+  for (int i = 0; i < bins; ++i) {
+    double bin_center = min_val + (i + 0.5) * bin_width; // Bin center
+    double bin_density = static_cast<double>(counts[i]) / (n * bin_width); // Probability density
+    density.emplace_back(bin_center, bin_density);
+  }
+
+  return density;
+}
+
+// Compute density using predefined bins
+inline std::vector<std::pair<double, double>> HistogramDensityEstWithBins(const std::vector<double>& data,
+                                                                          const std::vector<double>& bins) {
+  size_t n = data.size();
+  size_t bin_count = bins.size() - 1;
+
+  if (n < 2) {
+    throw std::invalid_argument("Data size must be at least 2.");
+  }
+
+  if (bins.size() < 2) {
+    throw std::invalid_argument("Bins vector must have at least two elements.");
+  }
+
+  // Check bins are sorted
+  if (!std::is_sorted(bins.begin(), bins.end())) {
+    throw std::invalid_argument("Bins vector must be sorted in ascending order.");
+  }
+
+  // Initialize counts for each bin
+  std::vector<int> counts(bin_count, 0);
+
+  // Count the number of data points in each bin
+  HistogramCountEdges(data.data(), n, bins.data(), bins.size(), counts.data());
+
+  // Compute density for each bin
+  std::vector<std::pair<double, double>> density;
+  for (size_t i = 0; i < bin_count; ++i) {
+    double bin_width = bins[i + 1] - bins[i];
+    if (bin_width <= 0) {
+      throw std::invalid_argument("Bin widths must be positive.");
+    }
+    double bin_center = (bins[i] + bins[i + 1]) / 2.0;
+    double bin_density = static_cast<double>(counts[i]) / (n * bin_width);
+    density.emplace_back(bin_center, bin_density);
+  }
+
+  return density;
+}
+
+} // namespace sshicm
+
+#endif // HistogramDensityEst_H
@@ -0,0 +1,221 @@
+#ifndef HistogramKernels_H
+#define HistogramKernels_H
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+namespace sshicm {
+
+// The x86 kernels are compiled for AVX2 through target attributes and chosen at run time, so
+// the package does not need -mavx2; aarch64 always has NEON, so that path is chosen at compile time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SSHICM_HISTOGRAM_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SSHICM_HISTOGRAM_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Number of bin indices computed per block before they are scattered into the counts
+const size_t kHistogramBlock = 256;
+
+// Scalar kernels, also used for the tails of the vector kernels
+inline void MinMaxScalar(const double* x, size_t n, double& min_val, double& max_val) {
+  for (size_t i = 0; i < n; ++i) {
+    min_val = x[i] < min_val ? x[i] : min_val;
+    max_val = x[i] > max_val ? x[i] : max_val;
+  }
+}
+
+inline void BinIndicesScalar(const double* x, size_t n,
+                             double min_val, double bin_width, int bins,
+                             int* bin_index) {
+  for (size_t i = 0; i < n; ++i) {
+    int index = static_cast<int>((x[i] - min_val) / bin_width);
+    bin_index[i] = index < bins ? index : bins - 1;
+  }
+}
+
+#if defined(SSHICM_HISTOGRAM_AVX2)
+inline bool HasAVX2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+__attribute__((target("avx2")))
+inline void MinMaxAVX2(const double* x, size_t n, double& min_val, double& max_val) {
+  __m256d vmin = _mm256_set1_pd(min_val);
+  __m256d vmax = _mm256_set1_pd(max_val);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d v = _mm256_loadu_pd(x + i);
+    vmin = _mm256_min_pd(vmin, v);
+    vmax = _mm256_max_pd(vmax, v);
+  }
+  double lanes_min[4], lanes_max[4];
+  _mm256_storeu_pd(lanes_min, vmin);
+  _mm256_storeu_pd(lanes_max, vmax);
+  MinMaxScalar(lanes_min, 4, min_val, max_val);
+  MinMaxScalar(lanes_max, 4, min_val, max_val);
+  MinMaxScalar(x + i, n - i, min_val, max_val);
+}
+
+__attribute__((target("avx2")))
+inline void BinIndicesAVX2(const double* x, size_t n,
+                           double min_val, double bin_width, int bins,
+                           int* bin_index) {
+  __m256d vmin = _mm256_set1_pd(min_val);
+  __m256d vwidth = _mm256_set1_pd(bin_width);
+  __m128i vlast = _mm_set1_epi32(bins - 1);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // Same operations as the scalar kernel: subtract, divide, truncate, fold into the last bin
+    __m256d q = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), vmin), vwidth);
+    __m128i index = _mm_min_epi32(_mm256_cvttpd_epi32(q), vlast);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bin_index + i), index);
+  }
+  BinIndicesScalar(x + i, n - i, min_val, bin_width, bins, bin_index + i);
+}
+#endif
+
+#if defined(SSHICM_HISTOGRAM_NEON)
+inline void MinMaxNEON(const double* x, size_t n, double& min_val, double& max_val) {
+  float64x2_t vmin = vdupq_n_f64(min_val);
+  float64x2_t vmax = vdupq_n_f64(max_val);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    float64x2_t v = vld1q_f64(x + i);
+    vmin = vminq_f64(vmin, v);
+    vmax = vmaxq_f64(vmax, v);
+  }
+  min_val = vminvq_f64(vmin);
+  max_val = vmaxvq_f64(vmax);
+  MinMaxScalar(x + i, n - i, min_val, max_val);
+}
+
+inline void BinIndicesNEON(const double* x, size_t n,
+                           double min_val, double bin_width, int bins,
+                           int* bin_index) {
+  float64x2_t vmin = vdupq_n_f64(min_val);
+  float64x2_t vwidth = vdupq_n_f64(bin_width);
+  int32x2_t vlast = vdup_n_s32(bins - 1);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    float64x2_t q = vdivq_f64(vsubq_f64(vld1q_f64(x + i), vmin), vwidth);
+    int32x2_t index = vmin_s32(vmovn_s64(vcvtq_s64_f64(q)), vlast);
+    vst1_s32(bin_index + i, index);
+  }
+  BinIndicesScalar(x + i, n - i, min_val, bin_width, bins, bin_index + i);
+}
+#endif
+
+// Minimum and maximum of x[0, n), n >= 1
+inline void HistogramMinMax(const double* x, size_t n, double& min_val, double& max_val) {
+  min_val = x[0];
+  max_val = x[0];
+#if defined(SSHICM_HISTOGRAM_AVX2)
+  if (HasAVX2()) {
+    MinMaxAVX2(x, n, min_val, max_val);
+    return;
+  }
+#elif defined(SSHICM_HISTOGRAM_NEON)
+  MinMaxNEON(x, n, min_val, max_val);
+  return;
+#endif
+  MinMaxScalar(x, n, min_val, max_val);
+}
+
+// Equal-width bin index of every value in x[0, n), all lying in [min_val, min_val + bins * bin_width]
+inline void HistogramBinIndices(const double* x, size_t n,
+                                double min_val, double bin_width, int bins,
+                                int* bin_index) {
+#if defined(SSHICM_HISTOGRAM_AVX2)
+  if (HasAVX2()) {
+    BinIndicesAVX2(x, n, min_val, bin_width, bins, bin_index);
+    return;
+  }
+#elif defined(SSHICM_HISTOGRAM_NEON)
+  BinIndicesNEON(x, n, min_val, bin_width, bins, bin_index);
+  return;
+#endif
+  BinIndicesScalar(x, n, min_val, bin_width, bins, bin_index);
+}
+
+// Add the equal-width bin counts of x[0, n), all lying in [min_val, min_val + bins * bin_width], to counts
+inline void HistogramCountUniform(const double* x, size_t n,
+                                  double min_val, double bin_width, int bins,
+                                  int* counts) {
+  int bin_index[kHistogramBlock];
+  for (size_t start = 0; start < n; start += kHistogramBlock) {
+    size_t block = std::min(kHistogramBlock, n - start);
+    HistogramBinIndices(x + start, block, min_val, bin_width, bins, bin_index);
+    for (size_t i = 0; i < block; ++i) {
+      counts[bin_index[i]]++;
+    }
+  }
+}
+
+// Number of edges that are <= value, by a binary search whose loop has no data-dependent branch
+inline size_t EdgeUpperBound(const double* edges, size_t edge_count, double value) {
+  const double* base = edges;
+  size_t len = edge_count;
+  while (len > 1) {
+    size_t half = len / 2;
+    base = (base[half] <= value) ? base + half : base;
+    len -= half;
+  }
+  return (base - edges) + (*base <= value);
+}
+
+// Add the counts of x[0, n) on ascending edges[0, edge_count) to counts[0, edge_count - 1);
+// bins are [edges[i], edges[i + 1]) except the last one, which also holds its right edge
+inline void HistogramCountEdges(const double* x, size_t n,
+                                const double* edges, size_t edge_count,
+                                int* counts) {
+  int bins = static_cast<int>(edge_count) - 1;
+  double first_edge = edges[0];
+  double last_edge = edges[edge_count - 1];
+  double bin_width = (last_edge - first_edge) / bins;
+
+  // Equal-width edges (as RelEntropy produces) give the bin directly; the estimate is then checked
+  // against the actual edges, so rounding in the edges can only move it by a step
+  bool uniform = bin_width > 0;
+  for (int i = 0; uniform && i < bins; ++i) {
+    uniform = std::fabs((edges[i + 1] - edges[i]) - bin_width) <= 1e-6 * bin_width;
+  }
+
+  if (uniform) {
+    for (size_t k = 0; k < n; ++k) {
+      double value = x[k];
+      if (!(value >= first_edge && value <= last_edge)) {
+        continue;
+      }
+      int i = static_cast<int>((value - first_edge) / bin_width);
+      i = std::max(0, std::min(i, bins - 1));
+      while (i > 0 && value < edges[i]) {
+        --i;
+      }
+      while (i < bins - 1 && value >= edges[i + 1]) {
+        ++i;
+      }
+      counts[i]++;
+    }
+    return;
+  }
+
+  for (size_t k = 0; k < n; ++k) {
+    double value = x[k];
+    size_t upper = EdgeUpperBound(edges, edge_count, value);
+    if (upper > 0 && upper < edge_count) {
+      counts[upper - 1]++;
+    } else if (value == last_edge) {
+      counts[bins - 1]++;
+    }
+  }
+}
+
+} // namespace sshicm
+
+#endif // HistogramKernels_H
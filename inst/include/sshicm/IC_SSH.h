@@ -0,0 +1,342 @@
+#ifndef IC_SSH_H
+#define IC_SSH_H
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <numeric>
+#include <thread>
+#include "HistogramDensityEst.h"
+#include "RelEntropy.h"
+#include "BinningRule.h"
+#include "Span.h"
+#include "StratumIndex.h"
+#include "Workspace.h"
+#include "PermutationTest.h"
+#include "PermutationRng.h"
+#include "PermutationPlan.h"
+#include "TailPValue.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+
+namespace sshicm {
+
+// Compute IC_SSH with the binning rule `Rule` from the stratum index of s (stratification
+// `variable` of the call, for the profiler) and a copy of d sorted in ascending order, which are
+// shared by every permutation; a non-empty permutation evaluates d[permutation[0]],
+// d[permutation[1]], ... instead of d, and the d values of each stratum are gathered in the workspace
+template <class Rule, class Profiler>
+double IC_SSH_IndexedImpl(Span<double> d,
+                          Span<int> permutation,
+                          const SortedData& sorted_d,
+                          const StratumIndex& strata,
+                          ICWorkspace& workspace,
+                          Profiler& profiler,
+                          size_t variable) {
+  if (strata.rows.size() != d.size()) {
+    throw std::invalid_argument("Vectors s and d must have the same length.");
+  }
+
+  double IC = 0.0;
+  for (size_t k = 0; k < strata.stratum_number(); ++k) {
+    // Step 1: Gather the values of d in stratum k, in row order
+    typename Profiler::Timer group_start = profiler.Now();
+    const int* rows = strata.rows.data() + strata.offsets[k];
+    int stratum_size = strata.stratum_size(k);
+    std::vector<double>& stratum_values = workspace.stratum_values;
+    stratum_values.resize(stratum_size);
+    if (permutation.empty()) {
+      for (int i = 0; i < stratum_size; ++i) {
+        stratum_values[i] = d[rows[i]];
+      }
+    } else {
+      for (int i = 0; i < stratum_size; ++i) {
+        stratum_values[i] = d[permutation[rows[i]]];
+      }
+    }
+    typename Profiler::Timer group_end = profiler.Now();
+    profiler.AddPhase(kProfileGroup, group_start, group_end);
+
+    // Step 2: Compute relative entropy for d_i and d
+    double rel_entropy = RelEntropySortedRule<Rule>(stratum_values, sorted_d, workspace.rel_entropy);
+    typename Profiler::Timer entropy_end = profiler.Now();
+    profiler.AddPhase(kProfileRelEntropy, group_end, entropy_end);
+    profiler.AddStratum(variable, k, group_start, entropy_end);
+
+    // Step 3: Compute contribution to IC, weighted by p(s_i)
+    double probability = static_cast<double>(stratum_size) / d.size();
+    IC += probability * (std::atan(rel_entropy) / (M_PI / 2));
+  }
+
+  return IC;
+}
+
+// Compute IC_SSH with the binning rule `Rule`, prepared as in IC_SSHICM_Batch
+template <class Rule>
+double IC_SSH_IndexedRule(Span<double> d,
+                          Span<int> permutation,
+                          Span<double> sorted_d,
+                          const StratumIndex& strata,
+                          ICWorkspace& workspace) {
+  NullProfiler profiler;
+  SortedData sorted_data(sorted_d, Rule::kNeedsMoments);
+  return IC_SSH_IndexedImpl<Rule>(d, permutation, sorted_data, strata, workspace, profiler, 0);
+}
+
+// Compute IC_SSH from the stratum index of s and a copy of d sorted in ascending order, which are
+// shared by every permutation; a non-empty permutation evaluates d[permutation[0]], d[permutation[1]],
+// ... instead of d, and the d values of each stratum are gathered in the workspace
+inline double IC_SSH_Indexed(Span<double> d,
+                             Span<int> permutation,
+                             Span<double> sorted_d,
+                             const StratumIndex& strata,
+                             const std::string& bin_method,
+                             ICWorkspace& workspace) {
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    return IC_SSH_IndexedRule<SturgesRule>(d, permutation, sorted_d, strata, workspace);
+  case kBinSquareRoot:
+    return IC_SSH_IndexedRule<SquareRootRule>(d, permutation, sorted_d, strata, workspace);
+  case kBinRice:
+    return IC_SSH_IndexedRule<RiceRule>(d, permutation, sorted_d, strata, workspace);
+  case kBinScott:
+    return IC_SSH_IndexedRule<ScottRule>(d, permutation, sorted_d, strata, workspace);
+  default:
+    return IC_SSH_IndexedRule<FreedmanDiaconisRule>(d, permutation, sorted_d, strata, workspace);
+  }
+}
+
+// Compute IC_SSH
+inline double IC_SSH(Span<double> d,
+                     Span<int> s,
+                     const std::string& bin_method) {
+  if (s.size() != d.size()) {
+    throw std::invalid_argument("Vectors s and d must have the same length.");
+  }
+  std::vector<double> sorted_d(d.begin(), d.end());
+  std::sort(sorted_d.begin(), sorted_d.end());
+  ICWorkspace workspace(d.size());
+  return IC_SSH_Indexed(d, Span<int>(), sorted_d, BuildStratumIndex(s), bin_method, workspace);
+}
+
+// Body of IC_SSHICM_Batch for the binning rule `Rule`, instrumented through `profiler`
+// (NullProfiler compiles the timers away)
+template <class Rule, class Profiler>
+std::vector<std::vector<double>> IC_SSHICM_BatchRule(Span<double> d,
+                                                     const std::vector<Span<int>>& s_list,
+                                                     unsigned int seed,
+                                                     int permutation_number,
+                                                     bool sequential,
+                                                     int exceed_threshold,
+                                                     double alpha,
+                                                     int threads,
+                                                     int batch_size,
+                                                     bool tail,
+                                                     const PermutationPlan* plan,
+                                                     Profiler& profiler) {
+  size_t variable_number = s_list.size();
+
+  // Step 1: Sort d once, as permuting d does not change its sorted values, together with the
+  // statistics the binning rule reads off it, and index the rows of each stratum once, as the
+  // stratifications are not permuted
+  typename Profiler::Timer setup_start = profiler.Now();
+  std::vector<double> sorted_values(d.begin(), d.end());
+  std::sort(sorted_values.begin(), sorted_values.end());
+  SortedData sorted_d(sorted_values, Rule::kNeedsMoments);
+  std::vector<StratumIndex> strata(variable_number);
+  ParallelFor(0, static_cast<int>(variable_number), [&](size_t v) {
+    strata[v] = BuildStratumIndex(s_list[v]);
+  }, threads);
+  profiler.CountBytes((sorted_values.size() + sorted_d.prefix_sum.size() +
+                       sorted_d.prefix_square_sum.size()) * sizeof(double));
+  for (const StratumIndex& index : strata) {
+    profiler.CountBytes((index.offsets.size() + index.rows.size()) * sizeof(int));
+  }
+  profiler.AddPhase(kProfileSetup, setup_start, profiler.Now());
+
+  // Step 2: Calculate the true IC values using the original d
+  typename Profiler::Timer observed_start = profiler.Now();
+  std::vector<double> true_IC(variable_number, 0.0);
+  ParallelFor(0, static_cast<int>(variable_number), [&](size_t v) {
+    ICWorkspace workspace(d.size());
+    NullProfiler observed_profiler;
+    true_IC[v] = IC_SSH_IndexedImpl<Rule>(d, Span<int>(), sorted_d, strata[v], workspace,
+                                          observed_profiler, v);
+  }, threads);
+  profiler.AddPhase(kProfileObserved, observed_start, profiler.Now());
+
+  // Step 3: Evaluate the permutations round by round. Within a round the permutations are split
+  // into contiguous blocks of batch_size (by default one block per thread), and each block checks
+  // out a workspace that is kept across blocks and rounds. A permutation is an array of row
+  // indices, so d itself is never copied
+  WorkspacePool<ICWorkspace> workspaces;
+  auto evaluate_round = [&](int first, int count, const std::vector<size_t>& active, std::vector<double>& results) {
+    ParallelForBlocks(count, threads, batch_size, [&](int begin, int end) {
+      typename Profiler::Timer task_start = profiler.Now();
+      Profiler task_profiler = profiler.Fork();
+      ICWorkspace& workspace = workspaces.Acquire();
+      if (workspace.permutation.size() != d.size()) {
+        workspace = ICWorkspace(d.size());
+      }
+      std::vector<int>& permutation = workspace.permutation;
+
+      for (int k = begin; k < end; ++k) {
+        task_profiler.Checkpoint();
+
+        // Step 3.1: Read the row indices off the plan, or shuffle them, keying the generator by the
+        // seed and the permutation index
+        typename Profiler::Timer shuffle_start = task_profiler.Now();
+        const int* planned = plan ? plan->Find(first + k) : nullptr;
+        if (!planned) {
+          std::iota(permutation.begin(), permutation.end(), 0);
+          PermutationRng rng(seed, first + k);
+          ShuffleInPlace(permutation.data(), permutation.size(), rng);
+        }
+        Span<int> rows = planned ? Span<int>(planned, d.size()) : Span<int>(permutation);
+        task_profiler.AddPhase(kProfileShuffle, shuffle_start, task_profiler.Now());
+
+        // Step 3.2: Compute IC of every remaining stratification for this permutation
+        for (size_t a = 0; a < active.size(); ++a) {
+          results[static_cast<size_t>(k) * active.size() + a] =
+            IC_SSH_IndexedImpl<Rule>(d, rows, sorted_d, strata[active[a]], workspace,
+                                     task_profiler, active[a]);
+        }
+      }
+      task_profiler.CountPermutations(end - begin);
+      task_profiler.CountEvaluations((end - begin) * static_cast<int>(active.size()));
+      workspaces.Release(workspace);
+      profiler.Merge(task_profiler, task_start);
+    });
+  };
+
+  // Step 4: Compute p-values by comparing permuted IC values to the true IC values
+  typename Profiler::Timer test_start = profiler.Now();
+  std::vector<std::vector<double>> permutation_values;
+  std::vector<std::vector<double>> result =
+    RunPermutationTest(true_IC, permutation_number, sequential, exceed_threshold, alpha, evaluate_round,
+                       tail ? &permutation_values : nullptr);
+  if (tail) {
+    AppendTailPValues(result, permutation_values, seed, threads);
+  }
+  profiler.AddPhase(kProfileTest, test_start, profiler.Now());
+  workspaces.ForEach([&](const ICWorkspace& workspace) {
+    profiler.CountBytes(workspace.Bytes());
+  });
+  return result;
+}
+
+// Body of IC_SSHICM_Batch: the binning method is resolved once here, and every permutation then
+// runs the kernel specialized for its rule
+template <class Profiler>
+std::vector<std::vector<double>> IC_SSHICM_BatchImpl(Span<double> d,
+                                                     const std::vector<Span<int>>& s_list,
+                                                     unsigned int seed,
+                                                     int permutation_number,
+                                                     const std::string& bin_method,
+                                                     bool sequential,
+                                                     int exceed_threshold,
+                                                     double alpha,
+                                                     int threads,
+                                                     int batch_size,
+                                                     bool tail,
+                                                     const PermutationPlan* plan,
+                                                     Profiler& profiler) {
+  for (Span<int> s : s_list) {
+    if (s.size() != d.size()) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+  }
+  CheckPermutationPlan(plan, d.size(), seed);
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    return IC_SSHICM_BatchRule<SturgesRule>(d, s_list, seed, permutation_number, sequential,
+                                            exceed_threshold, alpha, threads, batch_size, tail, plan, profiler);
+  case kBinSquareRoot:
+    return IC_SSHICM_BatchRule<SquareRootRule>(d, s_list, seed, permutation_number, sequential,
+                                               exceed_threshold, alpha, threads, batch_size, tail, plan,
+                                               profiler);
+  case kBinRice:
+    return IC_SSHICM_BatchRule<RiceRule>(d, s_list, seed, permutation_number, sequential,
+                                         exceed_threshold, alpha, threads, batch_size, tail, plan, profiler);
+  case kBinScott:
+    return IC_SSHICM_BatchRule<ScottRule>(d, s_list, seed, permutation_number, sequential,
+                                          exceed_threshold, alpha, threads, batch_size, tail, plan, profiler);
+  default:
+    return IC_SSHICM_BatchRule<FreedmanDiaconisRule>(d, s_list, seed, permutation_number, sequential,
+                                                     exceed_threshold, alpha, threads, batch_size,
+                                                     tail, plan, profiler);
+  }
+}
+
+// IC_SSHICM_Batch: IC values and p-values of several stratifications of the same d. Every
+// stratification is evaluated on each permutation of d, so the shuffles and the sorted d are
+// shared. Each result is {IC, p-value, permutations used}; with `sequential`, a stratification
+// stops early once its p-value is settled (see RunPermutationTest). With `tail`, the permutation
+// values are kept and each result also holds {tail p-value, goodness of fit} (see TailPValue).
+// A plan for the length of d and the seed supplies its stored permutations instead of shuffles
+inline std::vector<std::vector<double>> IC_SSHICM_Batch(Span<double> d,
+                                                        const std::vector<Span<int>>& s_list,
+                                                        unsigned int seed,
+                                                        int permutation_number,
+                                                        const std::string& bin_method = "Sturges",
+                                                        bool sequential = false,
+                                                        int exceed_threshold = 10,
+                                                        double alpha = 0.05,
+                                                        int threads = 0,
+                                                        int batch_size = 0,
+                                                        bool tail = false,
+                                                        const PermutationPlan* plan = nullptr) {
+  NullProfiler profiler;
+  return IC_SSHICM_BatchImpl(d, s_list, seed, permutation_number, bin_method, sequential,
+                             exceed_threshold, alpha, threads, batch_size, tail, plan, profiler);
+}
+
+// IC_SSHICM_BatchProfiled: IC_SSHICM_Batch that also fills `report` with per-phase timers and
+// counters (see Profiler.h)
+inline std::vector<std::vector<double>> IC_SSHICM_BatchProfiled(Span<double> d,
+                                                                const std::vector<Span<int>>& s_list,
+                                                                unsigned int seed,
+                                                                int permutation_number,
+                                                                const std::string& bin_method,
+                                                                bool sequential,
+                                                                int exceed_threshold,
+                                                                double alpha,
+                                                                int threads,
+                                                                int batch_size,
+                                                                bool tail,
+                                                                const PermutationPlan* plan,
+                                                                ProfileReport& report) {
+  PhaseProfiler profiler;
+  PhaseProfiler::Timer start = profiler.Now();
+  std::vector<std::vector<double>> result =
+    IC_SSHICM_BatchImpl(d, s_list, seed, permutation_number, bin_method, sequential,
+                        exceed_threshold, alpha, threads, batch_size, tail, plan, profiler);
+  report = profiler.Report();
+  report.wall_seconds = std::chrono::duration<double>(profiler.Now() - start).count();
+  return result;
+}
+
+// IC_SSHICM: Parallel computation of IC_SSH over permutations, returning IC value, p-value and the
+// number of permutations used (and with `tail` the tail p-value and its goodness of fit)
+inline std::vector<double> IC_SSHICM(Span<double> d,
+                                     Span<int> s,
+                                     unsigned int seed,
+                                     int permutation_number,
+                                     const std::string& bin_method = "Sturges",
+                                     bool sequential = false,
+                                     int exceed_threshold = 10,
+                                     double alpha = 0.05,
+                                     int threads = 0,
+                                     int batch_size = 0,
+                                     bool tail = false,
+                                     const PermutationPlan* plan = nullptr) {
+  return IC_SSHICM_Batch(d, std::vector<Span<int>>(1, s), seed, permutation_number, bin_method,
+                         sequential, exceed_threshold, alpha, threads, batch_size, tail, plan)[0];
+}
+
+} // namespace sshicm
+
+#endif // IC_SSH_H
@@ -0,0 +1,743 @@
+#ifndef IN_SSH_H
+#define IN_SSH_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <limits>
+#include <thread>
+#include "Span.h"
+#include "PermutationTest.h"
+#include "PermutationRng.h"
+#include "PermutationPlan.h"
+#include "TailPValue.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "StratumIndex.h"
+#include "Workspace.h"
+#include "AsymptoticTest.h"
+#include "PackedCodes.h"
+
+namespace sshicm {
+
+// Function to compute the frequency of each element in a vector
+inline std::map<int, int> ComputeFrequency(Span<int> data) {
+  std::map<int, int> frequency;
+  for (int value : data) {
+    frequency[value]++;
+  }
+  return frequency;
+}
+
+// Function to compute the joint frequency of two vectors
+inline std::map<std::pair<int, int>, int> ComputeJointFrequency(Span<int> d,
+                                                                Span<int> s) {
+  std::map<std::pair<int, int>, int> joint_frequency;
+  for (size_t i = 0; i < d.size(); ++i) {
+    joint_frequency[std::make_pair(s[i], d[i])]++;
+  }
+  return joint_frequency;
+}
+
+// Function to compute the probability distribution from frequency
+inline std::map<int, double> ComputeProb(const std::map<int, int>& frequency, int total_count) {
+  std::map<int, double> probability;
+  for (const auto& pair : frequency) {
+    probability[pair.first] = static_cast<double>(pair.second) / total_count;
+  }
+  return probability;
+}
+
+// Function to compute the joint probability distribution from joint frequency
+inline std::map<std::pair<int, int>, double> ComputeJointProb(const std::map<std::pair<int, int>, int>& joint_frequency, int total_count) {
+  std::map<std::pair<int, int>, double> joint_probability;
+  for (const auto& pair : joint_frequency) {
+    joint_probability[pair.first] = static_cast<double>(pair.second) / total_count;
+  }
+  return joint_probability;
+}
+
+// Function to compute the conditional probability distribution
+inline std::map<int, double> ComputeConditionalProb(const std::map<std::pair<int, int>, double>& joint_probability,
+                                                    const std::map<int, double>& marginal_probability, int s_value) {
+  std::map<int, double> conditional_probability;
+  for (const auto& pair : joint_probability) {
+    if (pair.first.first == s_value) {
+      conditional_probability[pair.first.second] = pair.second / marginal_probability.at(s_value);
+    }
+  }
+  return conditional_probability;
+}
+
+// Function to compute the entropy of a probability distribution
+inline double ComputeEntropy(const std::map<int, double>& probability) {
+  double entropy = 0.0;
+  for (const auto& pair : probability) {
+    if (pair.second > 0) {
+      entropy -= pair.second * std::log(pair.second);
+    }
+  }
+  return entropy;
+}
+
+// Function to compute the conditional entropy
+inline double ComputeConditionalEntropy(const std::map<int, double>& marginal_probability,
+                                        const std::map<std::pair<int, int>, double>& joint_probability) {
+  double conditional_entropy = 0.0;
+  for (const auto& marginal_pair : marginal_probability) {
+    int s_value = marginal_pair.first;
+    double s_probability = marginal_pair.second;
+    std::map<int, double> conditional_probability = ComputeConditionalProb(joint_probability, marginal_probability, s_value);
+    for (const auto& conditional_pair : conditional_probability) {
+      double x_probability = conditional_pair.second;
+      if (x_probability > 0) {
+        conditional_entropy -= s_probability * x_probability * std::log2(x_probability);
+      }
+    }
+  }
+  return conditional_entropy;
+}
+
+// Function to check whether a vector holds codes 1..levels that can be used in place and record the
+// number of levels. Codes may leave gaps, but levels may not exceed the length of the vector, so
+// that tables sized by the largest code stay bounded by n; other vectors go to ComputeDenseCodes
+inline bool ComputeDenseLevels(Span<int> data, int& levels) {
+  levels = 0;
+  for (int value : data) {
+    if (value < 1) {
+      return false;
+    }
+    if (value > levels) {
+      levels = value;
+    }
+  }
+  return static_cast<size_t>(levels) <= data.size();
+}
+
+// Function to recode a vector into dense codes 1..levels following the ascending order of its values
+inline std::vector<int> ComputeDenseCodes(Span<int> data, int& levels) {
+  std::vector<int> unique_values(data.begin(), data.end());
+  std::sort(unique_values.begin(), unique_values.end());
+  unique_values.erase(std::unique(unique_values.begin(), unique_values.end()), unique_values.end());
+  levels = unique_values.size();
+
+  std::vector<int> codes(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    codes[i] = std::lower_bound(unique_values.begin(), unique_values.end(), data[i]) - unique_values.begin() + 1;
+  }
+  return codes;
+}
+
+// Function to decide whether a flat s_levels x d_levels table is worth using for n observations
+inline bool UseDenseTable(int d_levels, int s_levels, size_t n) {
+  return static_cast<size_t>(d_levels) * s_levels <= std::max<size_t>(n, 65536);
+}
+
+// Function to count n dense codes, each in the type it is stored in, into an existing flat
+// s_levels x d_levels joint frequency table (row = s, column = d)
+template <class DCode, class SCode>
+void CountDenseJointFrequency(const DCode* d,
+                              const SCode* s,
+                              size_t n,
+                              int d_levels,
+                              int s_levels,
+                              int* joint_frequency) {
+  std::fill(joint_frequency, joint_frequency + static_cast<size_t>(s_levels) * d_levels, 0);
+  for (size_t i = 0; i < n; ++i) {
+    joint_frequency[static_cast<size_t>(s[i] - 1) * d_levels + (d[i] - 1)]++;
+  }
+}
+
+// Function to count dense codes into an existing flat s_levels x d_levels joint frequency table (row = s, column = d)
+inline void CountDenseJointFrequency(Span<int> d,
+                                     Span<int> s,
+                                     int d_levels,
+                                     int s_levels,
+                                     int* joint_frequency) {
+  CountDenseJointFrequency(d.data(), s.data(), d.size(), d_levels, s_levels, joint_frequency);
+}
+
+// Function to count dense codes of d against the packed codes of s into an existing flat
+// s_levels x d_levels joint frequency table, reading s in its packed type
+template <class DCode>
+void CountPackedJointFrequency(const DCode* d,
+                               const PackedCodes& s,
+                               size_t n,
+                               int d_levels,
+                               int s_levels,
+                               int* joint_frequency) {
+  if (s.bytes == 1) {
+    CountDenseJointFrequency(d, s.codes8.data(), n, d_levels, s_levels, joint_frequency);
+  } else if (s.bytes == 2) {
+    CountDenseJointFrequency(d, s.codes16.data(), n, d_levels, s_levels, joint_frequency);
+  } else {
+    CountDenseJointFrequency(d, s.codes32.data(), n, d_levels, s_levels, joint_frequency);
+  }
+}
+
+// Function to count dense codes into a flat s_levels x d_levels joint frequency table (row = s, column = d)
+inline std::vector<int> ComputeDenseJointFrequency(Span<int> d,
+                                                   Span<int> s,
+                                                   int d_levels,
+                                                   int s_levels) {
+  std::vector<int> joint_frequency(static_cast<size_t>(s_levels) * d_levels, 0);
+  CountDenseJointFrequency(d, s, d_levels, s_levels, joint_frequency.data());
+  return joint_frequency;
+}
+
+// Function to compute the entropy of a dense frequency vector
+inline double ComputeDenseEntropy(const std::vector<int>& frequency, int total_count) {
+  double entropy = 0.0;
+  for (int count : frequency) {
+    if (count > 0) {
+      double probability = static_cast<double>(count) / total_count;
+      entropy -= probability * std::log(probability);
+    }
+  }
+  return entropy;
+}
+
+// Function to compute the conditional entropy of d given s from a dense joint frequency table
+inline double ComputeDenseConditionalEntropy(const int* joint_frequency,
+                                             const std::vector<int>& s_frequency,
+                                             int d_levels,
+                                             int total_count) {
+  double conditional_entropy = 0.0;
+  for (size_t k = 0; k < s_frequency.size(); ++k) {
+    if (s_frequency[k] == 0) {
+      continue;
+    }
+    double s_probability = static_cast<double>(s_frequency[k]) / total_count;
+    const int* row = joint_frequency + k * d_levels;
+    for (int l = 0; l < d_levels; ++l) {
+      if (row[l] > 0) {
+        double x_probability = (static_cast<double>(row[l]) / total_count) / s_probability;
+        conditional_entropy -= s_probability * x_probability * std::log2(x_probability);
+      }
+    }
+  }
+  return conditional_entropy;
+}
+
+// Function to compute the conditional entropy of the n codes of d (dense codes 1..d_levels, in the
+// type they are stored in) given the strata of s, counting one stratum at a time into d_count, which
+// must hold d_levels zeros and is left zeroed; the terms are added in ascending order of s and then
+// of d, as ComputeConditionalEntropy does
+template <class DCode>
+double ComputeStratifiedConditionalEntropy(const DCode* d,
+                                           size_t n,
+                                           const StratumIndex& strata,
+                                           int* d_count,
+                                           int* touched_codes) {
+  int total_count = n;
+  double conditional_entropy = 0.0;
+  for (size_t k = 0; k < strata.stratum_number(); ++k) {
+    const int* rows = strata.rows.data() + strata.offsets[k];
+    int stratum_size = strata.stratum_size(k);
+    double s_probability = static_cast<double>(stratum_size) / total_count;
+
+    int touched_number = 0;
+    for (int i = 0; i < stratum_size; ++i) {
+      int code = d[rows[i]] - 1;
+      if (d_count[code]++ == 0) {
+        touched_codes[touched_number++] = code;
+      }
+    }
+    std::sort(touched_codes, touched_codes + touched_number);
+    for (int t = 0; t < touched_number; ++t) {
+      int code = touched_codes[t];
+      double x_probability = (static_cast<double>(d_count[code]) / total_count) / s_probability;
+      conditional_entropy -= s_probability * x_probability * std::log2(x_probability);
+      d_count[code] = 0;
+    }
+  }
+  return conditional_entropy;
+}
+
+// Function to compute the conditional entropy of d (dense codes 1..d_levels) given the strata of s,
+// as above
+inline double ComputeStratifiedConditionalEntropy(Span<int> d,
+                                                  const StratumIndex& strata,
+                                                  int* d_count,
+                                                  int* touched_codes) {
+  return ComputeStratifiedConditionalEntropy(d.data(), d.size(), strata, d_count, touched_codes);
+}
+
+// Function to compute the G statistic 2 * sum O * ln(O * n / (r * c)) of a dense joint frequency
+// table with row sums s_frequency and column sums d_frequency
+inline double ComputeDenseGStatistic(const int* joint_frequency,
+                                     const std::vector<int>& s_frequency,
+                                     const std::vector<int>& d_frequency,
+                                     int total_count) {
+  size_t d_levels = d_frequency.size();
+  double statistic = 0.0;
+  for (size_t k = 0; k < s_frequency.size(); ++k) {
+    const int* row = joint_frequency + k * d_levels;
+    for (size_t l = 0; l < d_levels; ++l) {
+      if (row[l] > 0) {
+        double expected = static_cast<double>(s_frequency[k]) * d_frequency[l] / total_count;
+        statistic += row[l] * std::log(row[l] / expected);
+      }
+    }
+  }
+  return 2.0 * statistic;
+}
+
+// Function to compute the G statistic of d (dense codes 1..d_levels, with frequency d_frequency)
+// against the strata of s, counting one stratum at a time into d_count as
+// ComputeStratifiedConditionalEntropy does
+inline double ComputeStratifiedGStatistic(Span<int> d,
+                                          const StratumIndex& strata,
+                                          const std::vector<int>& d_frequency,
+                                          int* d_count,
+                                          int* touched_codes) {
+  double total_count = d.size();
+  double statistic = 0.0;
+  for (size_t k = 0; k < strata.stratum_number(); ++k) {
+    const int* rows = strata.rows.data() + strata.offsets[k];
+    int stratum_size = strata.stratum_size(k);
+
+    int touched_number = 0;
+    for (int i = 0; i < stratum_size; ++i) {
+      int code = d[rows[i]] - 1;
+      if (d_count[code]++ == 0) {
+        touched_codes[touched_number++] = code;
+      }
+    }
+    for (int t = 0; t < touched_number; ++t) {
+      int code = touched_codes[t];
+      double expected = static_cast<double>(stratum_size) * d_frequency[code] / total_count;
+      statistic += d_count[code] * std::log(d_count[code] / expected);
+      d_count[code] = 0;
+    }
+  }
+  return 2.0 * statistic;
+}
+
+// Function to collect the non-zero counts of a frequency vector, as the margins of a G-test
+inline std::vector<int64_t> NonZeroCounts(const std::vector<int>& frequency) {
+  std::vector<int64_t> counts;
+  for (int count : frequency) {
+    if (count > 0) {
+      counts.push_back(count);
+    }
+  }
+  return counts;
+}
+
+// Function to compute IN_SSH from dense codes 1..d_levels and 1..s_levels using a flat contingency table
+inline double IN_SSH_Dense(Span<int> d,
+                           Span<int> s,
+                           int d_levels,
+                           int s_levels) {
+  int total_count = d.size();
+
+  // Step 1: Count the joint table in one pass and derive both marginals from its row/column sums
+  std::vector<int> joint_frequency = ComputeDenseJointFrequency(d, s, d_levels, s_levels);
+  std::vector<int> d_frequency(d_levels, 0);
+  std::vector<int> s_frequency(s_levels, 0);
+  for (int k = 0; k < s_levels; ++k) {
+    const int* row = joint_frequency.data() + static_cast<size_t>(k) * d_levels;
+    for (int l = 0; l < d_levels; ++l) {
+      s_frequency[k] += row[l];
+      d_frequency[l] += row[l];
+    }
+  }
+
+  // Step 2: Compute entropy of d
+  double I_d = ComputeDenseEntropy(d_frequency, total_count);
+
+  // Step 3: Compute conditional entropy of d given s
+  double I_d_given_s = ComputeDenseConditionalEntropy(joint_frequency.data(), s_frequency, d_levels, total_count);
+
+  // Step 4: Compute IN_SSH
+  return 1.0 - (I_d_given_s / I_d);
+}
+
+// Function to compute IN_SSH
+inline double IN_SSH(Span<int> d, Span<int> s) {
+  if (d.size() != s.size()) {
+    throw std::invalid_argument("Vectors d and s must have the same length.");
+  }
+
+  int total_count = d.size();
+
+  // Use the flat contingency table when both inputs are coded 1..K (as sshin() does) and the
+  // table is no larger than the data, otherwise fall back to the ordered maps below
+  int d_levels = 0;
+  int s_levels = 0;
+  if (ComputeDenseLevels(d, d_levels) && ComputeDenseLevels(s, s_levels) &&
+      UseDenseTable(d_levels, s_levels, d.size())) {
+    return IN_SSH_Dense(d, s, d_levels, s_levels);
+  }
+
+  // Step 1: Compute frequency and probability distributions
+  std::map<int, int> d_frequency = ComputeFrequency(d);
+  std::map<int, int> s_frequency = ComputeFrequency(s);
+  std::map<std::pair<int, int>, int> joint_frequency = ComputeJointFrequency(d, s);
+
+  std::map<int, double> d_probability = ComputeProb(d_frequency, total_count);
+  std::map<int, double> s_probability = ComputeProb(s_frequency, total_count);
+  std::map<std::pair<int, int>, double> joint_probability = ComputeJointProb(joint_frequency, total_count);
+
+  // Step 2: Compute entropy of d
+  double I_d = ComputeEntropy(d_probability);
+
+  // Step 3: Compute conditional entropy of d given s
+  double I_d_given_s = ComputeConditionalEntropy(s_probability, joint_probability);
+
+  // Step 4: Compute IN_SSH
+  double IN_SSH_value = 1.0 - (I_d_given_s / I_d);
+
+  return IN_SSH_value;
+}
+
+// Data of IN_SSHICM_Batch that no permutation changes: the dense codes of d with their frequency
+// and entropy, and for each stratification its codes and frequency, together with its codes packed
+// for the flat joint table (dense stratifications) or its stratum index (the others)
+struct INBatchData {
+  Span<int> d_codes;
+  int d_levels;
+  int total_count;
+  double I_d;
+  std::vector<int> d_frequency;
+  std::vector<Span<int>> s_codes;
+  std::vector<std::vector<int>> s_frequency;
+  std::vector<int> s_levels;
+  std::vector<bool> dense;
+  std::vector<PackedCodes> s_packed;
+  std::vector<StratumIndex> strata;
+  size_t max_cells;
+};
+
+// IN_SSH of stratification v of `data` for the (permuted) codes d of d, read in the type they are
+// stored in, using the worker's workspace and profiler
+template <class DCode, class Profiler>
+double IN_SSH_BatchEvaluate(const INBatchData& data,
+                            const DCode* d,
+                            size_t v,
+                            INWorkspaceT<DCode>& workspace,
+                            Profiler& profiler) {
+  double I_d_given_s;
+  typename Profiler::Timer table_start = profiler.Now();
+  if (data.dense[v]) {
+    CountPackedJointFrequency(d, data.s_packed[v], data.total_count, data.d_levels, data.s_levels[v],
+                              workspace.joint_frequency.data());
+    typename Profiler::Timer table_end = profiler.Now();
+    profiler.AddPhase(kProfileTable, table_start, table_end);
+    I_d_given_s = ComputeDenseConditionalEntropy(workspace.joint_frequency.data(), data.s_frequency[v],
+                                                 data.d_levels, data.total_count);
+    profiler.AddPhase(kProfileEntropy, table_end, profiler.Now());
+  } else {
+    I_d_given_s = ComputeStratifiedConditionalEntropy(d, data.total_count, data.strata[v],
+                                                      workspace.d_count.data(), workspace.touched_codes.data());
+    profiler.AddPhase(kProfileTable, table_start, profiler.Now());
+  }
+  return 1.0 - (I_d_given_s / data.I_d);
+}
+
+// Permutation test of the stratifications `permuted` of IN_SSHICM_Batch, with observed values
+// observed_IN_SSH, permuting the codes of d in the type `DCode` they are packed in (d_packed); a
+// permutation held by `plan` gathers the codes through its row indices instead of shuffling them
+template <class DCode, class Profiler>
+std::vector<std::vector<double>> IN_SSHICM_PermuteCoded(const INBatchData& data,
+                                                        const DCode* d_packed,
+                                                        const std::vector<size_t>& permuted,
+                                                        const std::vector<double>& observed_IN_SSH,
+                                                        unsigned int seed,
+                                                        int permutation_number,
+                                                        bool sequential,
+                                                        int exceed_threshold,
+                                                        double alpha,
+                                                        int threads,
+                                                        int batch_size,
+                                                        bool tail,
+                                                        const PermutationPlan* plan,
+                                                        Profiler& profiler) {
+  size_t n = data.d_codes.size();
+
+  // Step 1: Evaluate the permutations round by round. Within a round the permutations are split
+  // into contiguous blocks of batch_size (by default one block per thread), and each block checks
+  // out a workspace that is kept across blocks and rounds instead of allocating buffers per
+  // permutation
+  WorkspacePool<INWorkspaceT<DCode>> workspaces;
+  auto evaluate_round = [&](int first, int count, const std::vector<size_t>& active, std::vector<double>& results) {
+    ParallelForBlocks(count, threads, batch_size, [&](int begin, int end) {
+      typename Profiler::Timer task_start = profiler.Now();
+      Profiler task_profiler = profiler.Fork();
+      INWorkspaceT<DCode>& workspace = workspaces.Acquire();
+      if (workspace.permuted_d.size() != n) {
+        workspace = INWorkspaceT<DCode>(n, data.max_cells, data.d_levels);
+      }
+      std::vector<DCode>& permuted_d = workspace.permuted_d;
+
+      for (int k = begin; k < end; ++k) {
+        task_profiler.Checkpoint();
+
+        // Step 1.1: Permute the packed codes of d inside the reused buffer, through the row indices
+        // of the plan or by shuffling with the generator keyed by the seed and the permutation index
+        typename Profiler::Timer shuffle_start = task_profiler.Now();
+        const int* planned = plan ? plan->Find(first + k) : nullptr;
+        if (planned) {
+          for (size_t i = 0; i < n; ++i) {
+            permuted_d[i] = d_packed[planned[i]];
+          }
+        } else {
+          std::copy(d_packed, d_packed + n, permuted_d.begin());
+          PermutationRng rng(seed, first + k);
+          ShuffleInPlace(permuted_d.data(), permuted_d.size(), rng);
+        }
+        task_profiler.AddPhase(kProfileShuffle, shuffle_start, task_profiler.Now());
+
+        // Step 1.2: Only the joint table and the conditional entropy depend on the permutation
+        for (size_t a = 0; a < active.size(); ++a) {
+          results[static_cast<size_t>(k) * active.size() + a] =
+            IN_SSH_BatchEvaluate(data, permuted_d.data(), permuted[active[a]], workspace, task_profiler);
+        }
+      }
+      task_profiler.CountPermutations(end - begin);
+      task_profiler.CountEvaluations((end - begin) * static_cast<int>(active.size()));
+      workspaces.Release(workspace);
+      profiler.Merge(task_profiler, task_start);
+    });
+  };
+
+  // Step 2: Compute p-values by comparing permuted IN_SSH values to the true IN_SSH values
+  std::vector<std::vector<double>> permutation_values;
+  std::vector<std::vector<double>> result =
+    RunPermutationTest(observed_IN_SSH, permutation_number, sequential, exceed_threshold, alpha, evaluate_round,
+                       tail ? &permutation_values : nullptr);
+  if (tail) {
+    AppendTailPValues(result, permutation_values, seed, threads);
+  }
+  workspaces.ForEach([&](const INWorkspaceT<DCode>& workspace) {
+    profiler.CountBytes(workspace.Bytes());
+  });
+  return result;
+}
+
+// Body of IN_SSHICM_Batch, instrumented through `profiler` (NullProfiler compiles the timers away)
+template <class Profiler>
+std::vector<std::vector<double>> IN_SSHICM_BatchImpl(Span<int> d,
+                                                     const std::vector<Span<int>>& s_list,
+                                                     unsigned int seed,
+                                                     int permutation_number,
+                                                     bool sequential,
+                                                     int exceed_threshold,
+                                                     double alpha,
+                                                     int threads,
+                                                     int batch_size,
+                                                     PValueMethod pvalue,
+                                                     bool tail,
+                                                     const PermutationPlan* plan,
+                                                     Profiler& profiler) {
+  for (Span<int> s : s_list) {
+    if (s.size() != d.size()) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+  }
+  CheckPermutationPlan(plan, d.size(), seed);
+  size_t variable_number = s_list.size();
+  INBatchData data;
+  data.total_count = d.size();
+
+  // Step 1: Recode d to dense codes (keeping the value order, so IN_SSH is unchanged) and compute
+  // its frequency and entropy, which no permutation changes; input that is already coded 1..K,
+  // K <= n, is read in place
+  typename Profiler::Timer setup_start = profiler.Now();
+  data.d_levels = 0;
+  std::vector<int> d_recoded;
+  data.d_codes = d;
+  if (!ComputeDenseLevels(d, data.d_levels)) {
+    d_recoded = ComputeDenseCodes(d, data.d_levels);
+    data.d_codes = d_recoded;
+  }
+  data.d_frequency.assign(data.d_levels, 0);
+  for (int code : data.d_codes) {
+    data.d_frequency[code - 1]++;
+  }
+  data.I_d = ComputeDenseEntropy(data.d_frequency, data.total_count);
+
+  // Step 2: Recode each stratification and compute its frequency; stratifications whose joint
+  // table would be larger than the data are counted stratum by stratum through a stratum index,
+  // and the others keep their codes packed in the narrowest type for the permutations
+  std::vector<std::vector<int>> s_recoded(variable_number);
+  data.s_codes = s_list;
+  data.s_frequency.resize(variable_number);
+  data.s_levels.assign(variable_number, 0);
+  data.dense.assign(variable_number, false);
+  data.s_packed.resize(variable_number);
+  data.strata.resize(variable_number);
+  data.max_cells = 0;
+  for (size_t v = 0; v < variable_number; ++v) {
+    if (!ComputeDenseLevels(s_list[v], data.s_levels[v])) {
+      s_recoded[v] = ComputeDenseCodes(s_list[v], data.s_levels[v]);
+      data.s_codes[v] = s_recoded[v];
+    }
+    data.s_frequency[v].assign(data.s_levels[v], 0);
+    for (int code : data.s_codes[v]) {
+      data.s_frequency[v][code - 1]++;
+    }
+    data.dense[v] = UseDenseTable(data.d_levels, data.s_levels[v], d.size());
+    if (data.dense[v]) {
+      data.max_cells = std::max(data.max_cells, static_cast<size_t>(data.s_levels[v]) * data.d_levels);
+      data.s_packed[v] = PackedCodes(data.s_codes[v], data.s_levels[v]);
+    } else {
+      data.strata[v] = BuildStratumIndex(data.s_codes[v]);
+    }
+    profiler.CountBytes((s_recoded[v].size() + data.s_frequency[v].size() + data.strata[v].offsets.size() +
+                         data.strata[v].rows.size()) * sizeof(int) + data.s_packed[v].Bytes());
+  }
+  profiler.CountBytes((d_recoded.size() + data.d_frequency.size()) * sizeof(int));
+  profiler.AddPhase(kProfileSetup, setup_start, profiler.Now());
+
+  // Step 3: Calculate the true IN_SSH values using the original d, and for the asymptotic test
+  // their G statistics; the joint table of a dense stratification is still in the workspace. As
+  // for IC, only the whole pass is timed (kProfileObserved), so the table and entropy phases
+  // cover the permutations alone
+  typename Profiler::Timer observed_start = profiler.Now();
+  std::vector<double> true_IN_SSH(variable_number, 0.0);
+  std::vector<double> G_statistic(variable_number, 0.0);
+  ParallelFor(0, static_cast<int>(variable_number), [&](size_t v) {
+    INWorkspace workspace(0, data.max_cells, data.d_levels);
+    NullProfiler observed_profiler;
+    true_IN_SSH[v] = IN_SSH_BatchEvaluate(data, data.d_codes.data(), v, workspace, observed_profiler);
+    if (pvalue != kPValuePermutation) {
+      G_statistic[v] = data.dense[v] ?
+        ComputeDenseGStatistic(workspace.joint_frequency.data(), data.s_frequency[v], data.d_frequency,
+                               data.total_count) :
+        ComputeStratifiedGStatistic(data.d_codes, data.strata[v], data.d_frequency, workspace.d_count.data(),
+                                    workspace.touched_codes.data());
+    }
+  }, threads);
+
+  // Step 4: Take the asymptotic p-values where asked (with "auto", only where the expected
+  // counts allow it) and leave the other stratifications to the permutation test
+  std::vector<std::vector<double>> result(variable_number);
+  std::vector<size_t> permuted;
+  std::vector<double> permuted_IN_SSH;
+  std::vector<int64_t> d_margin = NonZeroCounts(data.d_frequency);
+  for (size_t v = 0; v < variable_number; ++v) {
+    if (pvalue != kPValuePermutation) {
+      GTestResult test = GTestFromMargins(G_statistic[v], NonZeroCounts(data.s_frequency[v]), d_margin,
+                                          data.total_count);
+      if (pvalue == kPValueAsymptotic || test.expected_counts_valid) {
+        result[v] = {true_IN_SSH[v], test.p_value, 0.0};
+        if (tail) {
+          result[v].push_back(test.p_value);
+          result[v].push_back(std::numeric_limits<double>::quiet_NaN());
+        }
+        continue;
+      }
+    }
+    permuted.push_back(v);
+    permuted_IN_SSH.push_back(true_IN_SSH[v]);
+  }
+  profiler.AddPhase(kProfileObserved, observed_start, profiler.Now());
+  if (permuted.empty()) {
+    return result;
+  }
+
+  // Step 5: Run the permutation test on the codes of d packed in the narrowest type, so that every
+  // permutation copies, shuffles and scans 1 or 2 bytes per row for up to 65535 categories
+  typename Profiler::Timer test_start = profiler.Now();
+  PackedCodes d_packed(data.d_codes, data.d_levels);
+  profiler.CountBytes(d_packed.Bytes());
+  std::vector<std::vector<double>> permuted_result;
+  if (d_packed.bytes == 1) {
+    permuted_result = IN_SSHICM_PermuteCoded(data, d_packed.codes8.data(), permuted, permuted_IN_SSH, seed,
+                                             permutation_number, sequential, exceed_threshold, alpha, threads,
+                                             batch_size, tail, plan, profiler);
+  } else if (d_packed.bytes == 2) {
+    permuted_result = IN_SSHICM_PermuteCoded(data, d_packed.codes16.data(), permuted, permuted_IN_SSH, seed,
+                                             permutation_number, sequential, exceed_threshold, alpha, threads,
+                                             batch_size, tail, plan, profiler);
+  } else {
+    permuted_result = IN_SSHICM_PermuteCoded(data, d_packed.codes32.data(), permuted, permuted_IN_SSH, seed,
+                                             permutation_number, sequential, exceed_threshold, alpha, threads,
+                                             batch_size, tail, plan, profiler);
+  }
+  for (size_t a = 0; a < permuted.size(); ++a) {
+    result[permuted[a]] = permuted_result[a];
+  }
+  profiler.AddPhase(kProfileTest, test_start, profiler.Now());
+  return result;
+}
+
+// IN_SSHICM_Batch: IN_SSH values and p-values of several stratifications of the same d. Every
+// stratification is evaluated on each permutation of d, so the shuffles, the recoded d, its
+// frequency and its entropy are shared. Each result is {IN_SSH, p-value, permutations used}; with
+// `sequential`, a stratification stops early once its p-value is settled (see RunPermutationTest).
+// With kPValueAsymptotic the p-value comes from the G-test (see AsymptoticTest.h) in one pass and
+// no permutations are used; kPValueAuto does so where Cochran's rule holds. With `tail`, the
+// permutation values are kept and each result also holds {tail p-value, goodness of fit} (see
+// TailPValue; asymptotic results repeat their p-value with a NaN goodness of fit). A plan for the
+// length of d and the seed supplies its stored permutations instead of shuffles
+inline std::vector<std::vector<double>> IN_SSHICM_Batch(Span<int> d,
+                                                        const std::vector<Span<int>>& s_list,
+                                                        unsigned int seed,
+                                                        int permutation_number,
+                                                        bool sequential = false,
+                                                        int exceed_threshold = 10,
+                                                        double alpha = 0.05,
+                                                        int threads = 0,
+                                                        int batch_size = 0,
+                                                        PValueMethod pvalue = kPValuePermutation,
+                                                        bool tail = false,
+                                                        const PermutationPlan* plan = nullptr) {
+  NullProfiler profiler;
+  return IN_SSHICM_BatchImpl(d, s_list, seed, permutation_number, sequential,
+                             exceed_threshold, alpha, threads, batch_size, pvalue, tail, plan, profiler);
+}
+
+// IN_SSHICM_BatchProfiled: IN_SSHICM_Batch that also fills `report` with per-phase timers and
+// counters (see Profiler.h)
+inline std::vector<std::vector<double>> IN_SSHICM_BatchProfiled(Span<int> d,
+                                                                const std::vector<Span<int>>& s_list,
+                                                                unsigned int seed,
+                                                                int permutation_number,
+                                                                bool sequential,
+                                                                int exceed_threshold,
+                                                                double alpha,
+                                                                int threads,
+                                                                int batch_size,
+                                                                PValueMethod pvalue,
+                                                                bool tail,
+                                                                const PermutationPlan* plan,
+                                                                ProfileReport& report) {
+  PhaseProfiler profiler;
+  PhaseProfiler::Timer start = profiler.Now();
+  std::vector<std::vector<double>> result =
+    IN_SSHICM_BatchImpl(d, s_list, seed, permutation_number, sequential,
+                        exceed_threshold, alpha, threads, batch_size, pvalue, tail, plan, profiler);
+  report = profiler.Report();
+  report.wall_seconds = std::chrono::duration<double>(profiler.Now() - start).count();
+  return result;
+}
+
+// IN_SSHICM: Parallel computation of IN_SSH over permutations, returning IN_SSH value, p-value
+// and the number of permutations used (and with `tail` the tail p-value and its goodness of fit)
+inline std::vector<double> IN_SSHICM(Span<int> d,
+                                     Span<int> s,
+                                     unsigned int seed,
+                                     int permutation_number,
+                                     bool sequential = false,
+                                     int exceed_threshold = 10,
+                                     double alpha = 0.05,
+                                     int threads = 0,
+                                     int batch_size = 0,
+                                     PValueMethod pvalue = kPValuePermutation,
+                                     bool tail = false,
+                                     const PermutationPlan* plan = nullptr) {
+  return IN_SSHICM_Batch(d, std::vector<Span<int>>(1, s), seed, permutation_number,
+                         sequential, exceed_threshold, alpha, threads, batch_size, pvalue, tail, plan)[0];
+}
+
+} // namespace sshicm
+
+#endif // IN_SSH_H
@@ -0,0 +1,234 @@
+#ifndef Interaction_H
+#define Interaction_H
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "Span.h"
+#include "ParallelFor.h"
+#include "AsymptoticTest.h"
+#include "PermutationPlan.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+
+namespace sshicm {
+
+// Interaction detection: IC or IN of d under the overlay s_i x s_j of every pair of p
+// stratifications. The pairs, together with the p stratifications themselves on the diagonal, are
+// evaluated as batches of IC_SSHICM_Batch / IN_SSHICM_Batch that share the invariants of d (sorted
+// values, frequency, entropy); the observed values are computed in parallel across pairs and each
+// permutation block evaluates every pair of its batch. The overlay of a pair is packed into one
+// integer code per row from the dense codes of both stratifications, and the diagonal reads those
+// codes in place. The p (p + 1) / 2 stratifications take O(p^2 n) memory in one batch, so they are
+// cut into batches of about kInteractionBatchCells codes; every permutation depends on the seed and
+// its index only (and the tail bootstrap on the seed and the observed value), so the batches draw
+// the same permutations and the results do not depend on the cut. A plan supplies the stored
+// permutations to every batch instead of shuffling them again.
+
+// Number of overlay codes held at once by an interaction batch (256 MB of int codes, plus the
+// stratum index the batch builds for each of them)
+const size_t kInteractionBatchCells = static_cast<size_t>(1) << 26;
+
+// Pairs (i, j), i <= j, of variable_number stratifications in the order of the interaction batch
+inline std::vector<std::pair<size_t, size_t>> InteractionPairs(size_t variable_number) {
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < variable_number; ++i) {
+    for (size_t j = i; j < variable_number; ++j) {
+      pairs.push_back(std::make_pair(i, j));
+    }
+  }
+  return pairs;
+}
+
+// Codes 1..K of the overlay of two stratifications with dense codes 1..levels1 and 1..levels2, in
+// ascending order of (s1, s2). Occurring combinations are looked up in a flat levels1 x levels2
+// table when it is no larger than the data, and ranked by sorting otherwise
+inline std::vector<int> CombineStrata(Span<int> s1, int levels1, Span<int> s2, int levels2) {
+  size_t n = s1.size();
+  std::vector<int> combined(n);
+  if (UseDenseTable(levels1, levels2, n)) {
+    std::vector<int> cell_codes(static_cast<size_t>(levels1) * levels2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      cell_codes[static_cast<size_t>(s1[i] - 1) * levels2 + (s2[i] - 1)] = 1;
+    }
+    int code = 0;
+    for (int& cell_code : cell_codes) {
+      if (cell_code) {
+        cell_code = ++code;
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      combined[i] = cell_codes[static_cast<size_t>(s1[i] - 1) * levels2 + (s2[i] - 1)];
+    }
+  } else {
+    std::vector<int64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+      keys[i] = static_cast<int64_t>(s1[i] - 1) * levels2 + (s2[i] - 1);
+    }
+    std::vector<int64_t> unique_keys(keys);
+    std::sort(unique_keys.begin(), unique_keys.end());
+    unique_keys.erase(std::unique(unique_keys.begin(), unique_keys.end()), unique_keys.end());
+    for (size_t i = 0; i < n; ++i) {
+      combined[i] = std::lower_bound(unique_keys.begin(), unique_keys.end(), keys[i]) - unique_keys.begin() + 1;
+    }
+  }
+  return combined;
+}
+
+// Dense codes of the stratifications of an interaction: the recoded copies of those that are not
+// coded 1..K, K <= n, and a view of the codes of every stratification
+struct InteractionCodes {
+  std::vector<std::vector<int>> recoded;
+  std::vector<Span<int>> codes;
+  std::vector<int> levels;
+};
+
+// Check the stratifications of an interaction and recode each to dense codes once
+inline void PrepareInteractionCodes(const std::vector<Span<int>>& s_list,
+                                    size_t d_size,
+                                    int threads,
+                                    InteractionCodes& codes) {
+  size_t variable_number = s_list.size();
+  if (variable_number < 2) {
+    throw std::invalid_argument("Interaction detection needs at least two stratifications.");
+  }
+  for (Span<int> s : s_list) {
+    if (s.size() != d_size) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+  }
+  codes.recoded.assign(variable_number, std::vector<int>());
+  codes.codes = s_list;
+  codes.levels.assign(variable_number, 0);
+  ParallelFor(0, static_cast<int>(variable_number), [&](size_t v) {
+    if (!ComputeDenseLevels(s_list[v], codes.levels[v])) {
+      codes.recoded[v] = ComputeDenseCodes(s_list[v], codes.levels[v]);
+      codes.codes[v] = codes.recoded[v];
+    }
+  }, threads);
+}
+
+// Stratifications of pairs [first, last) of InteractionPairs: the dense codes themselves on the
+// diagonal and the overlay of every other pair, built in parallel into `storage`, which the
+// returned spans view
+inline std::vector<Span<int>> InteractionStrata(const InteractionCodes& codes,
+                                                const std::vector<std::pair<size_t, size_t>>& pairs,
+                                                size_t first,
+                                                size_t last,
+                                                int threads,
+                                                std::vector<std::vector<int>>& storage) {
+  storage.assign(last - first, std::vector<int>());
+  ParallelFor(0, static_cast<int>(last - first), [&](size_t t) {
+    size_t i = pairs[first + t].first;
+    size_t j = pairs[first + t].second;
+    if (i != j) {
+      storage[t] = CombineStrata(codes.codes[i], codes.levels[i], codes.codes[j], codes.levels[j]);
+    }
+  }, threads);
+
+  std::vector<Span<int>> strata;
+  for (size_t t = first; t < last; ++t) {
+    bool diagonal = pairs[t].first == pairs[t].second;
+    strata.push_back(diagonal ? codes.codes[pairs[t].first] : Span<int>(storage[t - first]));
+  }
+  return strata;
+}
+
+// Results of all pairs of s_list in the order of InteractionPairs, from batch(strata) run on
+// successive batches of at most batch_pairs pairs (0: as many as kInteractionBatchCells allows)
+template <class Batch>
+std::vector<std::vector<double>> InteractionBatches(const std::vector<Span<int>>& s_list,
+                                                    size_t d_size,
+                                                    int threads,
+                                                    size_t batch_pairs,
+                                                    Batch batch) {
+  // Step 1: Recode each stratification to dense codes once
+  InteractionCodes codes;
+  PrepareInteractionCodes(s_list, d_size, threads, codes);
+
+  // Step 2: Evaluate the pairs batch by batch, keeping the overlays of one batch at a time
+  std::vector<std::pair<size_t, size_t>> pairs = InteractionPairs(s_list.size());
+  if (batch_pairs == 0) {
+    batch_pairs = std::max<size_t>(1, kInteractionBatchCells / std::max<size_t>(d_size, 1));
+  }
+  std::vector<std::vector<double>> result;
+  result.reserve(pairs.size());
+  for (size_t first = 0; first < pairs.size(); first += batch_pairs) {
+    size_t last = std::min(pairs.size(), first + batch_pairs);
+    std::vector<std::vector<int>> storage;
+    std::vector<Span<int>> strata = InteractionStrata(codes, pairs, first, last, threads, storage);
+    std::vector<std::vector<double>> batch_result = batch(strata);
+    result.insert(result.end(), batch_result.begin(), batch_result.end());
+  }
+  return result;
+}
+
+// Symmetric variable_number x variable_number matrix, row-major, of the batch results of
+// InteractionPairs; cell (i, j) holds the result of s_i x s_j and cell (i, i) that of s_i
+inline std::vector<std::vector<double>> InteractionMatrix(const std::vector<std::vector<double>>& result,
+                                                          size_t variable_number) {
+  std::vector<std::pair<size_t, size_t>> pairs = InteractionPairs(variable_number);
+  std::vector<std::vector<double>> matrix(variable_number * variable_number);
+  for (size_t t = 0; t < pairs.size(); ++t) {
+    matrix[pairs[t].first * variable_number + pairs[t].second] = result[t];
+    matrix[pairs[t].second * variable_number + pairs[t].first] = result[t];
+  }
+  return matrix;
+}
+
+// IC_SSHICM_Interaction: IC values and p-values of d under every pair of stratifications, as a
+// row-major p x p matrix of {IC, p-value, permutations used} (and with `tail` the tail p-value and
+// its goodness of fit; see IC_SSHICM_Batch). A plan for the length of d and the seed supplies the
+// permutations of every batch; batch_pairs caps the pairs per batch (0: as many as
+// kInteractionBatchCells allows)
+inline std::vector<std::vector<double>> IC_SSHICM_Interaction(Span<double> d,
+                                                              const std::vector<Span<int>>& s_list,
+                                                              unsigned int seed,
+                                                              int permutation_number,
+                                                              const std::string& bin_method = "Sturges",
+                                                              bool sequential = false,
+                                                              int exceed_threshold = 10,
+                                                              double alpha = 0.05,
+                                                              int threads = 0,
+                                                              int batch_size = 0,
+                                                              bool tail = false,
+                                                              const PermutationPlan* plan = nullptr,
+                                                              size_t batch_pairs = 0) {
+  return InteractionMatrix(InteractionBatches(s_list, d.size(), threads, batch_pairs,
+    [&](const std::vector<Span<int>>& strata) {
+      return IC_SSHICM_Batch(d, strata, seed, permutation_number, bin_method, sequential,
+                             exceed_threshold, alpha, threads, batch_size, tail, plan);
+    }), s_list.size());
+}
+
+// IN_SSHICM_Interaction: IN_SSH values and p-values of d under every pair of stratifications, as a
+// row-major p x p matrix of {IN_SSH, p-value, permutations used} (and with `tail` the tail p-value
+// and its goodness of fit; see IN_SSHICM_Batch). A plan for the length of d and the seed supplies
+// the permutations of every batch; batch_pairs caps the pairs per batch (0: as many as
+// kInteractionBatchCells allows)
+inline std::vector<std::vector<double>> IN_SSHICM_Interaction(Span<int> d,
+                                                              const std::vector<Span<int>>& s_list,
+                                                              unsigned int seed,
+                                                              int permutation_number,
+                                                              bool sequential = false,
+                                                              int exceed_threshold = 10,
+                                                              double alpha = 0.05,
+                                                              int threads = 0,
+                                                              int batch_size = 0,
+                                                              PValueMethod pvalue = kPValuePermutation,
+                                                              bool tail = false,
+                                                              const PermutationPlan* plan = nullptr,
+                                                              size_t batch_pairs = 0) {
+  return InteractionMatrix(InteractionBatches(s_list, d.size(), threads, batch_pairs,
+    [&](const std::vector<Span<int>>& strata) {
+      return IN_SSHICM_Batch(d, strata, seed, permutation_number, sequential,
+                             exceed_threshold, alpha, threads, batch_size, pvalue, tail, plan);
+    }), s_list.size());
+}
+
+} // namespace sshicm
+
+#endif // Interaction_H
@@ -0,0 +1,280 @@
+#ifndef Job_H
+#define Job_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include "Span.h"
+#include "AsymptoticTest.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+
+namespace sshicm {
+
+// Background jobs: IC_SSHICM_Batch / IN_SSHICM_Batch run on a thread of their own, so that the
+// caller gets a handle back at once and can poll the progress, read the results of the variables
+// done so far and cancel the job. A job tests its variables one after the other, each with the
+// batch of one variable, so that the results of a variable are final as soon as it is done; they
+// are identical to those of the batch of all variables, as every permutation depends on the seed
+// and its index only and the tail bootstrap on the seed and the observed value (TailBootstrapKey),
+// not on the position of the variable in its batch. Each job runs its loops on a StdThreadPool of
+// its own (see ParallelForPool), so concurrent jobs do not wait for each other's loops, and a job
+// owns copies of its data, so the caller may drop its own while the job runs.
+
+enum JobState {
+  kJobRunning,
+  kJobDone,
+  kJobCancelled,
+  kJobFailed
+};
+
+inline const char* JobStateName(JobState state) {
+  static const char* names[] = {"running", "done", "cancelled", "failed"};
+  return names[state];
+}
+
+// Thrown at a checkpoint of a cancelled job and caught by the job itself
+struct JobCancelled : std::exception {
+  const char* what() const noexcept override { return "Job cancelled."; }
+};
+
+// State shared by a job and the forks of its profiler: the cancellation flag and the number of
+// permutations evaluated
+class JobControl {
+public:
+  JobControl() : cancelled_(false), permutations_(0) {}
+
+  void Cancel() { cancelled_ = true; }
+  bool cancelled() const { return cancelled_; }
+  void AddPermutations(long long count) { permutations_ += count; }
+  long long permutations() const { return permutations_; }
+
+private:
+  std::atomic<bool> cancelled_;
+  std::atomic<long long> permutations_;
+};
+
+// Profiler that reports the progress of a job: every permutation is counted once it is evaluated,
+// and the checkpoint before each permutation throws JobCancelled once the job is cancelled, so a
+// cancelled job stops after the permutations under way. It keeps no timers.
+class JobProfiler {
+public:
+  typedef int Timer;
+
+  explicit JobProfiler(JobControl* control) : control_(control), started_(0), counted_(0) {}
+
+  Timer Now() const { return 0; }
+  void AddPhase(ProfilePhase, Timer, Timer) {}
+  void AddStratum(size_t, size_t, Timer, Timer) {}
+  void CountEvaluations(int) {}
+  void CountBytes(size_t) {}
+
+  // Called before each permutation of a block: the previous one of the block is done
+  void Checkpoint() {
+    if (started_ > counted_) {
+      control_->AddPermutations(1);
+      ++counted_;
+    }
+    if (control_->cancelled()) {
+      throw JobCancelled();
+    }
+    ++started_;
+  }
+
+  // Called once a block of count permutations is done: count those not counted yet
+  void CountPermutations(int count) {
+    control_->AddPermutations(count - counted_);
+    started_ = 0;
+    counted_ = 0;
+  }
+
+  JobProfiler Fork() const { return JobProfiler(control_); }
+  void Merge(const JobProfiler&, Timer) {}
+
+private:
+  JobControl* control_;
+  int started_;
+  int counted_;
+};
+
+// Progress of a job. permutations_total is an upper bound: sequential tests and asymptotic
+// p-values use fewer permutations
+struct JobStatus {
+  JobState state;
+  size_t variables_done;
+  size_t variable_number;
+  double permutations_done;
+  double permutations_total;
+  std::string error;
+};
+
+// Job that runs test(v, profiler) for every variable v in turn on a background thread, with a pool
+// of `threads` workers (0: all cores) that lives as long as that thread. Its owner polls and
+// cancels it from any thread; destroying a job cancels it and waits for its thread
+class SSHICMJob {
+public:
+  typedef std::function<std::vector<double>(size_t, JobProfiler&)> VariableTest;
+
+  SSHICMJob(size_t variable_number, int permutation_number, int threads, VariableTest test)
+    : test_(test), variable_number_(variable_number), permutation_number_(permutation_number),
+      threads_(ResolveThreadNumber(threads)), state_(kJobRunning), variables_done_(0),
+      results_(variable_number) {
+    thread_ = std::thread([this]() { Run(); });
+  }
+
+  ~SSHICMJob() {
+    Cancel();
+    Wait();
+  }
+
+  SSHICMJob(const SSHICMJob&) = delete;
+  SSHICMJob& operator=(const SSHICMJob&) = delete;
+
+  // Ask the job to stop at its next checkpoint; the results of the variables done are kept
+  void Cancel() { control_.Cancel(); }
+
+  // Block until the job has stopped; only its owner may call it
+  void Wait() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  JobStatus Status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    JobStatus status;
+    status.state = static_cast<JobState>(state_.load());
+    status.variables_done = variables_done_;
+    status.variable_number = variable_number_;
+    status.permutations_done = static_cast<double>(control_.permutations());
+    status.permutations_total = static_cast<double>(variable_number_) * permutation_number_;
+    status.error = error_;
+    return status;
+  }
+
+  // Results of the variables in the order of the batch, as IC_SSHICM_Batch / IN_SSHICM_Batch
+  // return them; variables not done yet have an empty result
+  std::vector<std::vector<double>> Results() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+  }
+
+private:
+  void Run() {
+    JobState state = kJobDone;
+    try {
+      StdThreadPool pool(threads_);
+      ParallelForPool() = &pool;
+      for (size_t v = 0; v < variable_number_; ++v) {
+        if (control_.cancelled()) {
+          throw JobCancelled();
+        }
+        JobProfiler profiler(&control_);
+        std::vector<double> result = test_(v, profiler);
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_[v] = result;
+        ++variables_done_;
+      }
+    } catch (const JobCancelled&) {
+      state = kJobCancelled;
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = e.what();
+      state = kJobFailed;
+    }
+    ParallelForPool() = nullptr;
+    state_ = state;
+  }
+
+  VariableTest test_;
+  size_t variable_number_;
+  int permutation_number_;
+  int threads_;
+  JobControl control_;
+  std::atomic<int> state_;
+  mutable std::mutex mutex_;
+  size_t variables_done_;
+  std::vector<std::vector<double>> results_;
+  std::string error_;
+  std::thread thread_;
+};
+
+// Check the arguments of a job before starting it, so that they fail in the caller
+inline void CheckJobArguments(size_t d_size, const std::vector<std::vector<int>>& s_list, int permutation_number) {
+  for (const std::vector<int>& s : s_list) {
+    if (s.size() != d_size) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+  }
+  if (permutation_number < 1) {
+    throw std::invalid_argument("Number of permutations must be positive.");
+  }
+}
+
+// StartIC_SSHICM_Job: start IC_SSHICM_Batch of d and s_list (see IC_SSHICM_Batch) in the background
+inline std::unique_ptr<SSHICMJob> StartIC_SSHICM_Job(std::vector<double> d,
+                                                     std::vector<std::vector<int>> s_list,
+                                                     unsigned int seed,
+                                                     int permutation_number,
+                                                     const std::string& bin_method = "Sturges",
+                                                     bool sequential = false,
+                                                     int exceed_threshold = 10,
+                                                     double alpha = 0.05,
+                                                     int threads = 0,
+                                                     int batch_size = 0,
+                                                     bool tail = false) {
+  CheckJobArguments(d.size(), s_list, permutation_number);
+  ParseBinningMethod(bin_method);
+  std::shared_ptr<std::vector<double>> d_data = std::make_shared<std::vector<double>>();
+  std::shared_ptr<std::vector<std::vector<int>>> s_data = std::make_shared<std::vector<std::vector<int>>>();
+  d_data->swap(d);
+  s_data->swap(s_list);
+  size_t variable_number = s_data->size();
+  return std::unique_ptr<SSHICMJob>(new SSHICMJob(variable_number, permutation_number, threads,
+    [=](size_t v, JobProfiler& profiler) {
+      std::vector<Span<int>> s(1, Span<int>((*s_data)[v]));
+      return IC_SSHICM_BatchImpl(Span<double>(*d_data), s, seed, permutation_number, bin_method, sequential,
+                                 exceed_threshold, alpha, threads, batch_size, tail,
+                                 static_cast<const PermutationPlan*>(nullptr), profiler)[0];
+    }));
+}
+
+// StartIN_SSHICM_Job: start IN_SSHICM_Batch of d and s_list (see IN_SSHICM_Batch) in the background
+inline std::unique_ptr<SSHICMJob> StartIN_SSHICM_Job(std::vector<int> d,
+                                                     std::vector<std::vector<int>> s_list,
+                                                     unsigned int seed,
+                                                     int permutation_number,
+                                                     bool sequential = false,
+                                                     int exceed_threshold = 10,
+                                                     double alpha = 0.05,
+                                                     int threads = 0,
+                                                     int batch_size = 0,
+                                                     PValueMethod pvalue = kPValuePermutation,
+                                                     bool tail = false) {
+  CheckJobArguments(d.size(), s_list, permutation_number);
+  std::shared_ptr<std::vector<int>> d_data = std::make_shared<std::vector<int>>();
+  std::shared_ptr<std::vector<std::vector<int>>> s_data = std::make_shared<std::vector<std::vector<int>>>();
+  d_data->swap(d);
+  s_data->swap(s_list);
+  size_t variable_number = s_data->size();
+  return std::unique_ptr<SSHICMJob>(new SSHICMJob(variable_number, permutation_number, threads,
+    [=](size_t v, JobProfiler& profiler) {
+      std::vector<Span<int>> s(1, Span<int>((*s_data)[v]));
+      return IN_SSHICM_BatchImpl(Span<int>(*d_data), s, seed, permutation_number, sequential,
+                                 exceed_threshold, alpha, threads, batch_size, pvalue, tail,
+                                 static_cast<const PermutationPlan*>(nullptr), profiler)[0];
+    }));
+}
+
+} // namespace sshicm
+
+#endif // Job_H
@@ -0,0 +1,295 @@
+#ifndef KdTree_H
+#define KdTree_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "Span.h"
+
+namespace sshicm {
+
+// Rows of n points in the plane in the order of a Hilbert curve through a 2^16 x 2^16 grid over their
+// bounding box, so that consecutive rows are close to each other
+inline std::vector<int> HilbertOrder(Span<double> x, Span<double> y) {
+  size_t n = x.size();
+  std::vector<int> order(n);
+  if (n == 0) {
+    return order;
+  }
+  double min_x = *std::min_element(x.begin(), x.end());
+  double max_x = *std::max_element(x.begin(), x.end());
+  double min_y = *std::min_element(y.begin(), y.end());
+  double max_y = *std::max_element(y.begin(), y.end());
+  const uint32_t side = 1u << 16;
+  double scale = (side - 1) / std::max(std::max(max_x - min_x, max_y - min_y), 1e-300);
+
+  std::vector<std::pair<uint64_t, int>> keys(n);
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t gx = static_cast<uint32_t>((x[i] - min_x) * scale);
+    uint32_t gy = static_cast<uint32_t>((y[i] - min_y) * scale);
+    uint64_t key = 0;
+    for (uint32_t s = side / 2; s > 0; s /= 2) {
+      uint32_t rx = (gx & s) ? 1 : 0;
+      uint32_t ry = (gy & s) ? 1 : 0;
+      key += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+      if (ry == 0) {
+        if (rx == 1) {
+          gx = side - 1 - gx;
+          gy = side - 1 - gy;
+        }
+        std::swap(gx, gy);
+      }
+    }
+    keys[i] = std::make_pair(key, static_cast<int>(i));
+  }
+  std::sort(keys.begin(), keys.end());
+  for (size_t i = 0; i < n; ++i) {
+    order[i] = keys[i].second;
+  }
+  return order;
+}
+
+// Static kd-tree over n points in the plane, for the windows of the local statistics. Nodes split
+// their points at the median of the wider side of their bounding box down to leaves of at most
+// leaf_size points, and the points are stored in leaf order.
+class KdTree {
+public:
+  KdTree(Span<double> x, Span<double> y, int leaf_size = 16)
+    : leaf_size_(std::max(leaf_size, 1)) {
+    if (x.size() != y.size()) {
+      throw std::invalid_argument("Vectors x and y must have the same length.");
+    }
+    size_t n = x.size();
+    order_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      order_[i] = static_cast<int>(i);
+    }
+    x_.assign(x.begin(), x.end());
+    y_.assign(y.begin(), y.end());
+    if (n > 0) {
+      Build(0, static_cast<int>(n));
+    }
+    for (size_t p = 0; p < n; ++p) {
+      x_[p] = x[order_[p]];
+      y_[p] = y[order_[p]];
+    }
+  }
+
+  size_t size() const { return order_.size(); }
+
+  // Rows of the k points nearest to (qx, qy), ties broken by row, in no particular order, and the
+  // distance of the k-th of them; heap is a scratch buffer kept by the caller
+  double Nearest(double qx, double qy, int k, std::vector<int>& rows, std::vector<std::pair<double, int>>& heap) const {
+    heap.clear();
+    rows.clear();
+    if (nodes_.empty() || k <= 0) {
+      return 0.0;
+    }
+    NearestIn(0, qx, qy, static_cast<size_t>(k), heap);
+    return TakeRows(heap, rows);
+  }
+
+  // Nearest() for a query whose k-th nearest point is known to lie within distance bound, e.g. the
+  // distance of the k-th neighbour of a previous query plus the distance between the two queries:
+  // the points within the bound are collected and the k nearest selected among them, which avoids
+  // the heap. Returns a negative distance, leaving the rows empty, when fewer than k points lie
+  // within the bound
+  double NearestWithin(double qx,
+                       double qy,
+                       int k,
+                       double bound,
+                       std::vector<int>& rows,
+                       std::vector<std::pair<double, int>>& candidates) const {
+    candidates.clear();
+    rows.clear();
+    if (nodes_.empty() || k <= 0) {
+      return 0.0;
+    }
+    double bound_square = bound * bound * (1.0 + 1e-9);
+    CollectIn(0, qx, qy, bound_square, candidates);
+    if (candidates.size() < static_cast<size_t>(k)) {
+      candidates.clear();
+      return -1.0;
+    }
+    std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+    candidates.resize(k);
+    return TakeRows(candidates, rows);
+  }
+
+  // Rows of the points within distance radius of (qx, qy), in no particular order
+  void WithinRadius(double qx, double qy, double radius, std::vector<int>& rows) const {
+    rows.clear();
+    if (nodes_.empty()) {
+      return;
+    }
+    WithinRadiusIn(0, qx, qy, radius * radius, rows);
+  }
+
+private:
+  // Points [begin, end) of order_ with their bounding box; inner nodes have two children
+  struct Node {
+    int begin;
+    int end;
+    int left;
+    int right;
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+  };
+
+  int Build(int begin, int end) {
+    int index = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node());
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.left = -1;
+    node.right = -1;
+    node.min_x = node.max_x = x_[order_[begin]];
+    node.min_y = node.max_y = y_[order_[begin]];
+    for (int p = begin + 1; p < end; ++p) {
+      node.min_x = std::min(node.min_x, x_[order_[p]]);
+      node.max_x = std::max(node.max_x, x_[order_[p]]);
+      node.min_y = std::min(node.min_y, y_[order_[p]]);
+      node.max_y = std::max(node.max_y, y_[order_[p]]);
+    }
+    if (end - begin > leaf_size_) {
+      int middle = begin + (end - begin) / 2;
+      const std::vector<double>& axis = node.max_x - node.min_x >= node.max_y - node.min_y ? x_ : y_;
+      std::nth_element(order_.begin() + begin, order_.begin() + middle, order_.begin() + end,
+                       [&](int a, int b) { return axis[a] < axis[b] || (axis[a] == axis[b] && a < b); });
+      node.left = Build(begin, middle);
+      node.right = Build(middle, end);
+    }
+    nodes_[index] = node;
+    return index;
+  }
+
+  // Squared distance from (qx, qy) to the bounding box of a node
+  static double BoxDistance(const Node& node, double qx, double qy) {
+    double dx = qx < node.min_x ? node.min_x - qx : (qx > node.max_x ? qx - node.max_x : 0.0);
+    double dy = qy < node.min_y ? node.min_y - qy : (qy > node.max_y ? qy - node.max_y : 0.0);
+    return dx * dx + dy * dy;
+  }
+
+  // Keep the k smallest (squared distance, row) pairs in a max-heap; nodes are only skipped when
+  // their box is strictly farther than the k-th candidate, so ties are broken by row exactly
+  void NearestIn(int index, double qx, double qy, size_t k, std::vector<std::pair<double, int>>& heap) const {
+    const Node& node = nodes_[index];
+    if (node.left < 0) {
+      for (int p = node.begin; p < node.end; ++p) {
+        double dx = x_[p] - qx;
+        double dy = y_[p] - qy;
+        std::pair<double, int> candidate(dx * dx + dy * dy, order_[p]);
+        if (heap.size() < k) {
+          heap.push_back(candidate);
+          std::push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+          ReplaceTop(heap, candidate);
+        }
+      }
+      return;
+    }
+    int near = node.left;
+    int far = node.right;
+    double near_distance = BoxDistance(nodes_[near], qx, qy);
+    double far_distance = BoxDistance(nodes_[far], qx, qy);
+    if (far_distance < near_distance) {
+      std::swap(near, far);
+      std::swap(near_distance, far_distance);
+    }
+    if (heap.size() < k || near_distance <= heap.front().first) {
+      NearestIn(near, qx, qy, k, heap);
+    }
+    if (heap.size() < k || far_distance <= heap.front().first) {
+      NearestIn(far, qx, qy, k, heap);
+    }
+  }
+
+  // Replace the largest pair of a max-heap and sift the new pair down, in one pass instead of the
+  // two of pop_heap and push_heap
+  static void ReplaceTop(std::vector<std::pair<double, int>>& heap, const std::pair<double, int>& candidate) {
+    size_t size = heap.size();
+    size_t hole = 0;
+    for (;;) {
+      size_t child = 2 * hole + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && heap[child] < heap[child + 1]) {
+        ++child;
+      }
+      if (!(candidate < heap[child])) {
+        break;
+      }
+      heap[hole] = heap[child];
+      hole = child;
+    }
+    heap[hole] = candidate;
+  }
+
+  // Rows of the candidates, and the largest candidate distance
+  static double TakeRows(const std::vector<std::pair<double, int>>& candidates, std::vector<int>& rows) {
+    double farthest = 0.0;
+    for (const std::pair<double, int>& candidate : candidates) {
+      rows.push_back(candidate.second);
+      farthest = std::max(farthest, candidate.first);
+    }
+    return std::sqrt(farthest);
+  }
+
+  void CollectIn(int index, double qx, double qy, double radius_square,
+                 std::vector<std::pair<double, int>>& candidates) const {
+    const Node& node = nodes_[index];
+    if (BoxDistance(node, qx, qy) > radius_square) {
+      return;
+    }
+    if (node.left < 0) {
+      for (int p = node.begin; p < node.end; ++p) {
+        double dx = x_[p] - qx;
+        double dy = y_[p] - qy;
+        double distance_square = dx * dx + dy * dy;
+        if (distance_square <= radius_square) {
+          candidates.push_back(std::make_pair(distance_square, order_[p]));
+        }
+      }
+      return;
+    }
+    CollectIn(node.left, qx, qy, radius_square, candidates);
+    CollectIn(node.right, qx, qy, radius_square, candidates);
+  }
+
+  void WithinRadiusIn(int index, double qx, double qy, double radius_square, std::vector<int>& rows) const {
+    const Node& node = nodes_[index];
+    if (BoxDistance(node, qx, qy) > radius_square) {
+      return;
+    }
+    if (node.left < 0) {
+      for (int p = node.begin; p < node.end; ++p) {
+        double dx = x_[p] - qx;
+        double dy = y_[p] - qy;
+        if (dx * dx + dy * dy <= radius_square) {
+          rows.push_back(order_[p]);
+        }
+      }
+      return;
+    }
+    WithinRadiusIn(node.left, qx, qy, radius_square, rows);
+    WithinRadiusIn(node.right, qx, qy, radius_square, rows);
+  }
+
+  int leaf_size_;
+  std::vector<int> order_;
+  std::vector<double> x_;     // by row while building, then in leaf order
+  std::vector<double> y_;
+  std::vector<Node> nodes_;
+};
+
+} // namespace sshicm
+
+#endif // KdTree_H
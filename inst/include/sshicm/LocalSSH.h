@@ -0,0 +1,456 @@
+#ifndef LocalSSH_H
+#define LocalSSH_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include "Span.h"
+#include "BinningRule.h"
+#include "StratumIndex.h"
+#include "Workspace.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "KdTree.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+
+namespace sshicm {
+
+// Local (moving-window) IC and IN: the statistic of d and each stratification inside the window of
+// every location, its `neighbours` nearest locations (itself included) or, with neighbours = 0, the
+// locations within `radius` of it. The windows come from a kd-tree over the coordinates, and the
+// locations are walked along a Hilbert curve in blocks that run in parallel: within a block each
+// window is reached from the previous one by removing the rows that left it and adding those that
+// entered it, so the state of a window (the contingency tables for IN, the sorted d values for IC)
+// is updated by the difference of two neighbouring windows only. IN is then read off the state in
+// O(1) per stratification, while IC, whose bins depend on the range of every stratum, is evaluated
+// in full on each window from the sorted values.
+
+// Check the arguments shared by the local statistics
+inline void CheckLocalArguments(size_t d_size,
+                                const std::vector<Span<int>>& s_list,
+                                Span<double> x,
+                                Span<double> y,
+                                int neighbours,
+                                double radius) {
+  for (Span<int> s : s_list) {
+    if (s.size() != d_size) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+  }
+  if (x.size() != d_size || y.size() != d_size) {
+    throw std::invalid_argument("Coordinates x and y must have the same length as d.");
+  }
+  for (size_t i = 0; i < d_size; ++i) {
+    if (!std::isfinite(x[i]) || !std::isfinite(y[i])) {
+      throw std::invalid_argument("Coordinates x and y must be finite.");
+    }
+  }
+  if (neighbours <= 0 && !(radius > 0)) {
+    throw std::invalid_argument("A window needs a positive number of neighbours or a positive radius.");
+  }
+}
+
+// Buffers of a walk over the windows: the previous and the current window, the rows that left and
+// entered the window between them, the scratch buffer of the queries, and for every row the step at
+// which it was last in a window, which finds the difference of two windows without sorting them
+struct LocalWindowBuffers {
+  std::vector<int> previous;
+  std::vector<int> current;
+  std::vector<int> removed;
+  std::vector<int> added;
+  std::vector<std::pair<double, int>> heap;
+  std::vector<int> last_step;
+  int step = 0;
+
+  // Rows that left (in previous only) and entered (in current only) the window
+  void Difference() {
+    removed.clear();
+    added.clear();
+    ++step;
+    for (int row : current) {
+      if (last_step[row] != step - 1) {
+        added.push_back(row);
+      }
+      last_step[row] = step;
+    }
+    for (int row : previous) {
+      if (last_step[row] != step) {
+        removed.push_back(row);
+      }
+    }
+  }
+};
+
+// Walk the windows of all locations in blocks of batch_size locations (1024 by default) in
+// parallel. Each block checks out a state, which prepare(state) sets up on first use and which is
+// empty at the start of a block; the state follows the window through state.Add(row) and
+// state.Remove(row), and evaluate(state, location, window) records the statistic of each location
+// from the state and the rows of its window, in no particular order. The state is emptied again at
+// the end of the block
+template <class State, class Prepare, class Evaluate>
+void WalkLocalWindows(Span<double> x,
+                      Span<double> y,
+                      int neighbours,
+                      double radius,
+                      int threads,
+                      int batch_size,
+                      Prepare prepare,
+                      Evaluate evaluate) {
+  KdTree tree(x, y);
+  std::vector<int> order = HilbertOrder(x, y);
+  int k = static_cast<int>(std::min<size_t>(std::max(neighbours, 0), x.size()));
+  WorkspacePool<State> states;
+  WorkspacePool<LocalWindowBuffers> buffers;
+  ParallelForBlocks(static_cast<int>(order.size()), threads, batch_size > 0 ? batch_size : 1024,
+                    [&](int begin, int end) {
+    State& state = states.Acquire();
+    prepare(state);
+    LocalWindowBuffers& window = buffers.Acquire();
+    if (window.last_step.size() != x.size()) {
+      window.last_step.assign(x.size(), -1);
+    }
+    window.previous.clear();
+    window.step += 2;
+    double reach = -1.0;
+    for (int p = begin; p < end; ++p) {
+      // Step 1: Find the window of the location; the k nearest neighbours lie within the reach of
+      // the previous window plus the distance between the two locations
+      int location = order[p];
+      if (k > 0) {
+        if (reach >= 0.0) {
+          int last = order[p - 1];
+          double step = std::hypot(x[location] - x[last], y[location] - y[last]);
+          reach = tree.NearestWithin(x[location], y[location], k, reach + step, window.current, window.heap);
+        }
+        if (reach < 0.0) {
+          reach = tree.Nearest(x[location], y[location], k, window.current, window.heap);
+        }
+      } else {
+        tree.WithinRadius(x[location], y[location], radius, window.current);
+      }
+
+      // Step 2: Move the state from the previous window to this one
+      window.Difference();
+      for (int row : window.removed) {
+        state.Remove(row);
+      }
+      for (int row : window.added) {
+        state.Add(row);
+      }
+
+      // Step 3: Evaluate the statistic of the window
+      evaluate(state, location, window.current);
+      window.previous.swap(window.current);
+    }
+    for (int row : window.previous) {
+      state.Remove(row);
+    }
+    state.Reset();
+    buffers.Release(window);
+    states.Release(state);
+  });
+}
+
+// x log(x) in base e and in base 2, with 0 log(0) = 0
+inline double XLogX(int count) {
+  return count > 0 ? count * std::log(static_cast<double>(count)) : 0.0;
+}
+
+inline double XLog2X(int count) {
+  return count > 0 ? count * std::log2(static_cast<double>(count)) : 0.0;
+}
+
+// Largest count table of a window that is kept as a flat array: kLocalDenseCells cells, or
+// kLocalDenseCellsPerRow cells per row of the largest window when that bound is known (k nearest
+// neighbours). A window touches at most one cell per row, so larger tables go to a hash map, and
+// the tables of every stratification and pooled state stay proportional to the windows rather than
+// to the levels of the whole data
+const size_t kLocalDenseCells = 4096;
+const size_t kLocalDenseCellsPerRow = 4;
+
+inline bool UseLocalDenseTable(size_t cells, size_t window_bound) {
+  return cells <= std::max(kLocalDenseCells, kLocalDenseCellsPerRow * window_bound);
+}
+
+// Counts of a window by cell, in a flat array or in a hash map (see UseLocalDenseTable)
+struct LocalCellCounts {
+  bool dense = true;
+  std::vector<int> cells;
+  std::unordered_map<int64_t, int> sparse_cells;
+
+  LocalCellCounts() {}
+  LocalCellCounts(size_t cell_number, size_t window_bound)
+    : dense(UseLocalDenseTable(cell_number, window_bound)) {
+    if (dense) {
+      cells.assign(cell_number, 0);
+    }
+  }
+
+  int& operator[](int64_t cell) { return dense ? cells[cell] : sparse_cells[cell]; }
+
+  // Forget a cell whose count went back to 0
+  void Drop(int64_t cell) {
+    if (!dense) {
+      sparse_cells.erase(cell);
+    }
+  }
+};
+
+// Counts of one window for IN_SSH of d and one stratification, with the sums of n log n that the
+// entropies are made of: H(d) = ln N - sum_l c_l ln c_l / N and H(d | s) = (sum_k n_k log2 n_k -
+// sum_kl n_kl log2 n_kl) / N, in the bases IN_SSH uses. Each table is sized by the window bound
+// rather than by n (see UseLocalDenseTable)
+struct LocalINCounts {
+  int d_levels = 0;
+  int total = 0;
+  int d_distinct = 0;
+  double d_sum = 0.0;
+  double s_sum = 0.0;
+  double joint_sum = 0.0;
+  LocalCellCounts d_count;
+  LocalCellCounts s_count;
+  LocalCellCounts joint_count;
+
+  LocalINCounts() {}
+  LocalINCounts(int d_levels_, int s_levels, size_t window_bound)
+    : d_levels(d_levels_), d_count(d_levels_, window_bound), s_count(s_levels, window_bound),
+      joint_count(static_cast<size_t>(s_levels) * d_levels_, window_bound) {}
+
+  // Add change (1 or -1) to the counts of a row with dense codes d_code and s_code
+  void Update(int d_code, int s_code, int change) {
+    int& d_cell = d_count[d_code - 1];
+    d_distinct += (d_cell + change > 0) - (d_cell > 0);
+    d_sum += XLogX(d_cell + change) - XLogX(d_cell);
+    d_cell += change;
+    if (d_cell == 0) {
+      d_count.Drop(d_code - 1);
+    }
+    int& s_cell = s_count[s_code - 1];
+    s_sum += XLog2X(s_cell + change) - XLog2X(s_cell);
+    s_cell += change;
+    if (s_cell == 0) {
+      s_count.Drop(s_code - 1);
+    }
+    int64_t key = static_cast<int64_t>(s_code - 1) * d_levels + (d_code - 1);
+    int& joint_cell = joint_count[key];
+    joint_sum += XLog2X(joint_cell + change) - XLog2X(joint_cell);
+    joint_cell += change;
+    if (joint_cell == 0) {
+      joint_count.Drop(key);
+    }
+    total += change;
+  }
+
+  // IN_SSH of the window, NaN where it is undefined (d constant in the window)
+  double Value() const {
+    if (d_distinct <= 1) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    double I_d = std::log(static_cast<double>(total)) - d_sum / total;
+    double I_d_given_s = (s_sum - joint_sum) / total;
+    return 1.0 - (I_d_given_s / I_d);
+  }
+
+  // Clear the sums of an empty window, so that rounding does not carry over to the next block
+  void Reset() {
+    d_sum = 0.0;
+    s_sum = 0.0;
+    joint_sum = 0.0;
+  }
+};
+
+// State of an IN window: the counts of d with each stratification
+struct LocalINState {
+  const std::vector<int>* d_codes = nullptr;
+  const std::vector<std::vector<int>>* s_codes = nullptr;
+  std::vector<LocalINCounts> counts;
+
+  void Add(int row) {
+    for (size_t v = 0; v < counts.size(); ++v) {
+      counts[v].Update((*d_codes)[row], (*s_codes)[v][row], 1);
+    }
+  }
+
+  void Remove(int row) {
+    for (size_t v = 0; v < counts.size(); ++v) {
+      counts[v].Update((*d_codes)[row], (*s_codes)[v][row], -1);
+    }
+  }
+
+  void Reset() {
+    for (LocalINCounts& variable_counts : counts) {
+      variable_counts.Reset();
+    }
+  }
+};
+
+// IN_SSH_Local: IN_SSH of d and each stratification of s_list in the window of every location
+// (x, y), as result[v][location]; equal up to rounding to IN_SSH of the rows of the window, and NaN
+// where d is constant in the window
+inline std::vector<std::vector<double>> IN_SSH_Local(Span<int> d,
+                                                     const std::vector<Span<int>>& s_list,
+                                                     Span<double> x,
+                                                     Span<double> y,
+                                                     int neighbours,
+                                                     double radius = 0.0,
+                                                     int threads = 0,
+                                                     int batch_size = 0) {
+  CheckLocalArguments(d.size(), s_list, x, y, neighbours, radius);
+  size_t variable_number = s_list.size();
+
+  // Step 1: Recode d and every stratification to dense codes once
+  int d_levels = 0;
+  std::vector<int> d_codes = ComputeDenseCodes(d, d_levels);
+  std::vector<std::vector<int>> s_codes(variable_number);
+  std::vector<int> s_levels(variable_number, 0);
+  ParallelFor(0, static_cast<int>(variable_number), [&](size_t v) {
+    s_codes[v] = ComputeDenseCodes(s_list[v], s_levels[v]);
+  }, threads);
+
+  // Step 2: Walk the windows, updating the counts of every stratification by the rows that left
+  // and entered the window; the size of radius windows is not known in advance
+  size_t window_bound = neighbours > 0 ? std::min<size_t>(neighbours, d.size()) : 0;
+  std::vector<std::vector<double>> result(variable_number, std::vector<double>(d.size(), 0.0));
+  auto prepare = [&](LocalINState& state) {
+    if (state.counts.size() != variable_number) {
+      state.d_codes = &d_codes;
+      state.s_codes = &s_codes;
+      for (size_t v = 0; v < variable_number; ++v) {
+        state.counts.push_back(LocalINCounts(d_levels, s_levels[v], window_bound));
+      }
+    }
+  };
+  auto evaluate = [&](const LocalINState& state, int location, const std::vector<int>&) {
+    for (size_t v = 0; v < variable_number; ++v) {
+      result[v][location] = state.counts[v].Value();
+    }
+  };
+  WalkLocalWindows<LocalINState>(x, y, neighbours, radius, threads, batch_size, prepare, evaluate);
+  return result;
+}
+
+// State of an IC window: the d values of the window in ascending order, kept sorted as rows enter
+// and leave it, with the buffers of the statistic and of the stratum index of each window
+struct LocalICState {
+  Span<double> d;
+  std::vector<double> sorted_values;
+  std::vector<double> window_d;
+  std::vector<int> window_s;
+  StratumIndex index;
+  StratumIndexBuffers index_buffers;
+  ICWorkspace workspace;
+
+  void Add(int row) {
+    sorted_values.insert(std::upper_bound(sorted_values.begin(), sorted_values.end(), d[row]), d[row]);
+  }
+
+  void Remove(int row) {
+    sorted_values.erase(std::lower_bound(sorted_values.begin(), sorted_values.end(), d[row]));
+  }
+
+  void Reset() {}
+};
+
+// Whether IC_SSH is defined for the window and stratum index of an IC state: the range of every
+// stratum must hold at least two d values of the window
+inline bool LocalICDefined(const LocalICState& state) {
+  const std::vector<double>& sorted_values = state.sorted_values;
+  for (size_t k = 0; k < state.index.stratum_number(); ++k) {
+    const int* rows = state.index.rows.data() + state.index.offsets[k];
+    double min_value = state.window_d[rows[0]];
+    double max_value = min_value;
+    for (int i = 1; i < state.index.stratum_size(k); ++i) {
+      min_value = std::min(min_value, state.window_d[rows[i]]);
+      max_value = std::max(max_value, state.window_d[rows[i]]);
+    }
+    if (std::upper_bound(sorted_values.begin(), sorted_values.end(), max_value) -
+        std::lower_bound(sorted_values.begin(), sorted_values.end(), min_value) < 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Body of IC_SSH_Local for the binning rule `Rule`
+template <class Rule>
+std::vector<std::vector<double>> IC_SSH_LocalRule(Span<double> d,
+                                                  const std::vector<Span<int>>& s_list,
+                                                  Span<double> x,
+                                                  Span<double> y,
+                                                  int neighbours,
+                                                  double radius,
+                                                  int threads,
+                                                  int batch_size) {
+  size_t variable_number = s_list.size();
+  std::vector<std::vector<double>> result(variable_number, std::vector<double>(d.size(), 0.0));
+  auto prepare = [&](LocalICState& state) {
+    state.d = d;
+  };
+
+  // IC of each stratification from the sorted window; IC_SSH does not depend on the order of the
+  // rows, which the window lists in no particular order. Only the sorted d values follow the window
+  // incrementally: the strata of every window are indexed again (into buffers kept by the state)
+  // and IC is evaluated in full. IC is undefined, and NaN, where the range of a stratum holds a
+  // single d value of the window, as its histogram then has no bins
+  auto evaluate = [&](LocalICState& state, int location, const std::vector<int>& window) {
+    state.window_d.resize(window.size());
+    state.window_s.resize(window.size());
+    for (size_t i = 0; i < window.size(); ++i) {
+      state.window_d[i] = d[window[i]];
+    }
+    SortedData sorted_d(state.sorted_values, Rule::kNeedsMoments);
+    for (size_t v = 0; v < variable_number; ++v) {
+      for (size_t i = 0; i < window.size(); ++i) {
+        state.window_s[i] = s_list[v][window[i]];
+      }
+      BuildStratumIndex(state.window_s, state.index, state.index_buffers);
+      if (!LocalICDefined(state)) {
+        result[v][location] = std::numeric_limits<double>::quiet_NaN();
+        continue;
+      }
+      NullProfiler profiler;
+      result[v][location] = IC_SSH_IndexedImpl<Rule>(state.window_d, Span<int>(), sorted_d, state.index,
+                                                     state.workspace, profiler, v);
+    }
+  };
+  WalkLocalWindows<LocalICState>(x, y, neighbours, radius, threads, batch_size, prepare, evaluate);
+  return result;
+}
+
+// IC_SSH_Local: IC_SSH of d and each stratification of s_list in the window of every location
+// (x, y), as result[v][location]; equal to IC_SSH of the rows of the window, and NaN where it is
+// undefined
+inline std::vector<std::vector<double>> IC_SSH_Local(Span<double> d,
+                                                     const std::vector<Span<int>>& s_list,
+                                                     Span<double> x,
+                                                     Span<double> y,
+                                                     int neighbours,
+                                                     double radius = 0.0,
+                                                     const std::string& bin_method = "Sturges",
+                                                     int threads = 0,
+                                                     int batch_size = 0) {
+  CheckLocalArguments(d.size(), s_list, x, y, neighbours, radius);
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    return IC_SSH_LocalRule<SturgesRule>(d, s_list, x, y, neighbours, radius, threads, batch_size);
+  case kBinSquareRoot:
+    return IC_SSH_LocalRule<SquareRootRule>(d, s_list, x, y, neighbours, radius, threads, batch_size);
+  case kBinRice:
+    return IC_SSH_LocalRule<RiceRule>(d, s_list, x, y, neighbours, radius, threads, batch_size);
+  case kBinScott:
+    return IC_SSH_LocalRule<ScottRule>(d, s_list, x, y, neighbours, radius, threads, batch_size);
+  default:
+    return IC_SSH_LocalRule<FreedmanDiaconisRule>(d, s_list, x, y, neighbours, radius, threads, batch_size);
+  }
+}
+
+} // namespace sshicm
+
+#endif // LocalSSH_H
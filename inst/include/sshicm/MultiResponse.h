@@ -0,0 +1,273 @@
+#ifndef MultiResponse_H
+#define MultiResponse_H
+
+#include <vector>
+#include <cmath>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "Span.h"
+#include "BinningRule.h"
+#include "StratumIndex.h"
+#include "Workspace.h"
+#include "PermutationTest.h"
+#include "PermutationRng.h"
+#include "TailPValue.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+#include "PackedCodes.h"
+
+namespace sshicm {
+
+// Multi-response tests: IC or IN of one stratification s against many target variables, the
+// columns of a column-major n x response_number matrix. The stratum index of s (the rows and
+// p(s_i) of each stratum) is built once for all targets, and the targets share the permutations:
+// a permutation moves the rows of the stratum index once, and every target is then read stratum by
+// stratum through the moved index. The same seed gives the same permutations, and so the same
+// results, as IC_SSHICM / IN_SSHICM of each target on its own; with `tail` the tail p-values agree
+// too, as their bootstrap is keyed by the seed and the observed value (TailBootstrapKey) rather
+// than by the column of the target. Targets are recoded as in IN_SSHICM_Batch, so sparse codes
+// never size a table beyond n levels.
+
+// Buffers of a multi-response permutation block: the shuffled row indices, the stratum index of s
+// with its rows moved by them, and the buffers of the statistic
+struct MultiResponseWorkspace {
+  std::vector<int> permutation;
+  StratumIndex permuted_strata;
+  ICWorkspace ic;
+  INWorkspace in;
+
+  size_t Bytes() const {
+    return (permutation.capacity() + permuted_strata.offsets.capacity() + permuted_strata.rows.capacity()) *
+      sizeof(int) + ic.Bytes() + in.Bytes();
+  }
+};
+
+// Check that a column-major matrix of response_number targets has one row per element of s, and
+// return the number of rows
+inline size_t CheckResponseMatrix(size_t matrix_size, size_t response_number, size_t n) {
+  if (response_number == 0 || matrix_size != response_number * n) {
+    throw std::invalid_argument("Matrix d must have one row per element of s.");
+  }
+  return n;
+}
+
+// Shuffle the row indices of permutation index `key` and move the rows of strata by them, so that
+// stratum k of the result reads d[permutation[rows[i]]], i.e. the rows of the permuted d
+inline void PermuteStrata(const StratumIndex& strata, unsigned int seed, int key, MultiResponseWorkspace& workspace) {
+  std::vector<int>& permutation = workspace.permutation;
+  std::iota(permutation.begin(), permutation.end(), 0);
+  PermutationRng rng(seed, key);
+  ShuffleInPlace(permutation.data(), permutation.size(), rng);
+  for (size_t i = 0; i < strata.rows.size(); ++i) {
+    workspace.permuted_strata.rows[i] = permutation[strata.rows[i]];
+  }
+}
+
+// Permutation test of every target with the statistic statistic(t, strata, workspace) of target t
+// on a (moved) stratum index, sharing each permutation of the rows across the active targets
+template <class Statistic>
+std::vector<std::vector<double>> RunMultiResponseTest(const StratumIndex& strata,
+                                                      const std::vector<double>& observed,
+                                                      unsigned int seed,
+                                                      int permutation_number,
+                                                      bool sequential,
+                                                      int exceed_threshold,
+                                                      double alpha,
+                                                      int threads,
+                                                      int batch_size,
+                                                      bool tail,
+                                                      Statistic statistic) {
+  WorkspacePool<MultiResponseWorkspace> workspaces;
+  auto evaluate_round = [&](int first, int count, const std::vector<size_t>& active, std::vector<double>& results) {
+    ParallelForBlocks(count, threads, batch_size, [&](int begin, int end) {
+      MultiResponseWorkspace& workspace = workspaces.Acquire();
+      if (workspace.permutation.size() != strata.rows.size()) {
+        workspace.permutation.resize(strata.rows.size());
+        workspace.permuted_strata = strata;
+      }
+      for (int k = begin; k < end; ++k) {
+        PermuteStrata(strata, seed, first + k, workspace);
+        for (size_t a = 0; a < active.size(); ++a) {
+          results[static_cast<size_t>(k) * active.size() + a] =
+            statistic(active[a], workspace.permuted_strata, workspace);
+        }
+      }
+      workspaces.Release(workspace);
+    });
+  };
+
+  std::vector<std::vector<double>> permutation_values;
+  std::vector<std::vector<double>> result =
+    RunPermutationTest(observed, permutation_number, sequential, exceed_threshold, alpha, evaluate_round,
+                       tail ? &permutation_values : nullptr);
+  if (tail) {
+    AppendTailPValues(result, permutation_values, seed, threads);
+  }
+  return result;
+}
+
+// Body of IC_SSHICM_MultiResponse for the binning rule `Rule`
+template <class Rule>
+std::vector<std::vector<double>> IC_SSHICM_MultiResponseRule(Span<double> d,
+                                                             size_t response_number,
+                                                             Span<int> s,
+                                                             unsigned int seed,
+                                                             int permutation_number,
+                                                             bool sequential,
+                                                             int exceed_threshold,
+                                                             double alpha,
+                                                             int threads,
+                                                             int batch_size,
+                                                             bool tail) {
+  size_t n = CheckResponseMatrix(d.size(), response_number, s.size());
+
+  // Step 1: Index the strata of s once for all targets
+  StratumIndex strata = BuildStratumIndex(s);
+
+  // Step 2: Sort each target once, with the statistics its binning rule reads off it
+  std::vector<std::vector<double>> sorted_values(response_number);
+  std::vector<SortedData> sorted_d(response_number);
+  ParallelFor(0, static_cast<int>(response_number), [&](size_t t) {
+    sorted_values[t].assign(d.data() + t * n, d.data() + (t + 1) * n);
+    std::sort(sorted_values[t].begin(), sorted_values[t].end());
+    sorted_d[t] = SortedData(sorted_values[t], Rule::kNeedsMoments);
+  }, threads);
+
+  // IC of target t for the (moved) stratum index
+  auto statistic = [&](size_t t, const StratumIndex& index, MultiResponseWorkspace& workspace) {
+    NullProfiler profiler;
+    return IC_SSH_IndexedImpl<Rule>(Span<double>(d.data() + t * n, n), Span<int>(), sorted_d[t], index,
+                                    workspace.ic, profiler, t);
+  };
+
+  // Step 3: Calculate the true IC values of the targets in parallel
+  std::vector<double> true_IC(response_number, 0.0);
+  ParallelFor(0, static_cast<int>(response_number), [&](size_t t) {
+    MultiResponseWorkspace workspace;
+    true_IC[t] = statistic(t, strata, workspace);
+  }, threads);
+
+  // Step 4: Compute p-values over the shared permutations
+  return RunMultiResponseTest(strata, true_IC, seed, permutation_number, sequential, exceed_threshold, alpha,
+                              threads, batch_size, tail, statistic);
+}
+
+// IC_SSHICM_MultiResponse: IC values and p-values of one stratification s against each column of
+// the column-major n x response_number matrix d, as {IC, p-value, permutations used} (and with
+// `tail` the tail p-value and its goodness of fit) per target, as IC_SSHICM_Batch returns them
+inline std::vector<std::vector<double>> IC_SSHICM_MultiResponse(Span<double> d,
+                                                                size_t response_number,
+                                                                Span<int> s,
+                                                                unsigned int seed,
+                                                                int permutation_number,
+                                                                const std::string& bin_method = "Sturges",
+                                                                bool sequential = false,
+                                                                int exceed_threshold = 10,
+                                                                double alpha = 0.05,
+                                                                int threads = 0,
+                                                                int batch_size = 0,
+                                                                bool tail = false) {
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    return IC_SSHICM_MultiResponseRule<SturgesRule>(d, response_number, s, seed, permutation_number, sequential,
+                                                    exceed_threshold, alpha, threads, batch_size, tail);
+  case kBinSquareRoot:
+    return IC_SSHICM_MultiResponseRule<SquareRootRule>(d, response_number, s, seed, permutation_number, sequential,
+                                                       exceed_threshold, alpha, threads, batch_size, tail);
+  case kBinRice:
+    return IC_SSHICM_MultiResponseRule<RiceRule>(d, response_number, s, seed, permutation_number, sequential,
+                                                 exceed_threshold, alpha, threads, batch_size, tail);
+  case kBinScott:
+    return IC_SSHICM_MultiResponseRule<ScottRule>(d, response_number, s, seed, permutation_number, sequential,
+                                                  exceed_threshold, alpha, threads, batch_size, tail);
+  default:
+    return IC_SSHICM_MultiResponseRule<FreedmanDiaconisRule>(d, response_number, s, seed, permutation_number,
+                                                             sequential, exceed_threshold, alpha, threads,
+                                                             batch_size, tail);
+  }
+}
+
+// IN_SSHICM_MultiResponse: IN_SSH values and p-values of one stratification s against each column
+// of the column-major n x response_number matrix d, as {IN_SSH, p-value, permutations used} (and
+// with `tail` the tail p-value and its goodness of fit) per target. The conditional entropy of each
+// target is counted stratum by stratum (ComputeStratifiedConditionalEntropy) from its packed codes
+inline std::vector<std::vector<double>> IN_SSHICM_MultiResponse(Span<int> d,
+                                                                size_t response_number,
+                                                                Span<int> s,
+                                                                unsigned int seed,
+                                                                int permutation_number,
+                                                                bool sequential = false,
+                                                                int exceed_threshold = 10,
+                                                                double alpha = 0.05,
+                                                                int threads = 0,
+                                                                int batch_size = 0,
+                                                                bool tail = false) {
+  size_t n = CheckResponseMatrix(d.size(), response_number, s.size());
+
+  // Step 1: Index the strata of s once for all targets
+  StratumIndex strata = BuildStratumIndex(s);
+
+  // Step 2: Recode each target to dense codes, packed in the narrowest type that holds them, and
+  // compute its entropy, which no permutation changes; targets already coded 1..K, K <= n, are
+  // read in place
+  std::vector<std::vector<int>> d_recoded(response_number);
+  std::vector<Span<int>> d_codes(response_number);
+  std::vector<PackedCodes> d_packed(response_number);
+  std::vector<int> d_levels(response_number, 0);
+  std::vector<double> I_d(response_number, 0.0);
+  ParallelFor(0, static_cast<int>(response_number), [&](size_t t) {
+    Span<int> column(d.data() + t * n, n);
+    d_codes[t] = column;
+    if (!ComputeDenseLevels(column, d_levels[t])) {
+      d_recoded[t] = ComputeDenseCodes(column, d_levels[t]);
+      d_codes[t] = d_recoded[t];
+    }
+    std::vector<int> d_frequency(d_levels[t], 0);
+    for (int code : d_codes[t]) {
+      d_frequency[code - 1]++;
+    }
+    I_d[t] = ComputeDenseEntropy(d_frequency, n);
+    d_packed[t] = PackedCodes(d_codes[t], d_levels[t]);
+  }, threads);
+  int max_levels = *std::max_element(d_levels.begin(), d_levels.end());
+
+  // IN_SSH of target t for the (moved) stratum index
+  auto statistic = [&](size_t t, const StratumIndex& index, MultiResponseWorkspace& workspace) {
+    if (workspace.in.d_count.size() < static_cast<size_t>(max_levels)) {
+      workspace.in = INWorkspace(0, 0, max_levels);
+    }
+    int* d_count = workspace.in.d_count.data();
+    int* touched_codes = workspace.in.touched_codes.data();
+    double I_d_given_s;
+    if (d_packed[t].bytes == 1) {
+      I_d_given_s = ComputeStratifiedConditionalEntropy(d_packed[t].codes8.data(), n, index, d_count,
+                                                        touched_codes);
+    } else if (d_packed[t].bytes == 2) {
+      I_d_given_s = ComputeStratifiedConditionalEntropy(d_packed[t].codes16.data(), n, index, d_count,
+                                                        touched_codes);
+    } else {
+      I_d_given_s = ComputeStratifiedConditionalEntropy(d_packed[t].codes32.data(), n, index, d_count,
+                                                        touched_codes);
+    }
+    return 1.0 - (I_d_given_s / I_d[t]);
+  };
+
+  // Step 3: Calculate the true IN_SSH values of the targets in parallel
+  std::vector<double> true_IN_SSH(response_number, 0.0);
+  ParallelFor(0, static_cast<int>(response_number), [&](size_t t) {
+    MultiResponseWorkspace workspace;
+    true_IN_SSH[t] = statistic(t, strata, workspace);
+  }, threads);
+
+  // Step 4: Compute p-values over the shared permutations
+  return RunMultiResponseTest(strata, true_IN_SSH, seed, permutation_number, sequential, exceed_threshold, alpha,
+                              threads, batch_size, tail, statistic);
+}
+
+} // namespace sshicm
+
+#endif // MultiResponse_H
@@ -0,0 +1,50 @@
+#ifndef PackedCodes_H
+#define PackedCodes_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Span.h"
+
+namespace sshicm {
+
+// Bytes per row of codes 1..levels in the narrowest type that holds them
+inline int CodeBytes(int levels) {
+  if (levels <= 0xFF) {
+    return 1;
+  } else if (levels <= 0xFFFF) {
+    return 2;
+  }
+  return 4;
+}
+
+// Dense codes 1..levels of a stratification or a nominal target, stored as uint8_t up to 255
+// levels and as uint16_t up to 65535; wider codes are the int codes themselves, viewed in place (so
+// they must outlive the packed codes). Kernels that scan codes on every permutation read them in
+// their packed type, which cuts the memory they stream per row from 4 bytes to 1 or 2
+struct PackedCodes {
+  int bytes;
+  std::vector<uint8_t> codes8;
+  std::vector<uint16_t> codes16;
+  Span<int> codes32;
+
+  PackedCodes() : bytes(4) {}
+  PackedCodes(Span<int> codes, int levels) : bytes(CodeBytes(levels)) {
+    if (bytes == 1) {
+      codes8.assign(codes.begin(), codes.end());
+    } else if (bytes == 2) {
+      codes16.assign(codes.begin(), codes.end());
+    } else {
+      codes32 = codes;
+    }
+  }
+
+  // Bytes owned by the packed copy
+  size_t Bytes() const {
+    return codes8.capacity() * sizeof(uint8_t) + codes16.capacity() * sizeof(uint16_t);
+  }
+};
+
+} // namespace sshicm
+
+#endif // PackedCodes_H
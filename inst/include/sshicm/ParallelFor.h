@@ -0,0 +1,234 @@
+#ifndef ParallelFor_H
+#define ParallelFor_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The core runs its parallel loops through a backend: a class with a static member
+//   template <class F> static void ParallelFor(int begin, int end, F f, int threads);
+// that calls f(i) for every i in [begin, end) on `threads` workers and returns once all calls are
+// done. StdThreadBackend is the default; the R package defines SSHICM_USE_RCPPTHREAD to run on
+// RcppThread instead, and other clients can define SSHICM_PARALLEL_BACKEND to a class of their
+// own, declared before any header of the core is included.
+#if defined(SSHICM_USE_RCPPTHREAD)
+#include <RcppThread.h>
+#endif
+
+namespace sshicm {
+
+// Number of worker threads used for a requested count, where 0 (or less) means all available cores
+inline int ResolveThreadNumber(int threads) {
+  if (threads > 0) {
+    return threads;
+  }
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Fixed set of std::threads that run a task together with the calling thread
+class StdThreadPool {
+public:
+  explicit StdThreadPool(int threads) : stop_(false), generation_(0), pending_(0), task_(nullptr) {
+    for (int w = 1; w < threads; ++w) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  ~StdThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  int thread_number() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Run task() once on every worker and once on the calling thread, and return when all are done;
+  // task must not throw
+  void RunOnAll(const std::function<void()>& task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    pending_ = workers_.size();
+    ++generation_;
+    lock.unlock();
+    wake_.notify_all();
+    task();
+    lock.lock();
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+private:
+  void WorkerLoop() {
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      const std::function<void()>* task = task_;
+      lock.unlock();
+      (*task)();
+      lock.lock();
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  bool stop_;
+  unsigned long generation_;
+  size_t pending_;
+  const std::function<void()>* task_;
+};
+
+// Backend on a std::thread pool that persists across calls and is only rebuilt when the thread
+// count changes. The loop body is type-erased, so every loop of the process runs on the same pool:
+// loops started from several threads at once take turns on it, and a loop body must not start
+// another loop. Indices are handed out one at a time, and the first exception thrown by f is
+// rethrown once all workers stop. RunOn() runs a loop on a pool of the caller's own instead, such
+// as the pool of a background job (see ParallelForPool).
+struct StdThreadBackend {
+  template <class F>
+  static void ParallelFor(int begin, int end, F f, int threads) {
+    Run(begin, end, std::function<void(int)>(f), threads);
+  }
+
+  static void Run(int begin, int end, const std::function<void(int)>& f, int threads) {
+    if (end <= begin) {
+      return;
+    }
+    static std::mutex call_mutex;
+    static std::unique_ptr<StdThreadPool> pool;
+    std::lock_guard<std::mutex> call_lock(call_mutex);
+    threads = ResolveThreadNumber(threads);
+    if (!pool || pool->thread_number() != threads) {
+      pool.reset(new StdThreadPool(threads));
+    }
+    RunOn(*pool, begin, end, f);
+  }
+
+  // Run a loop on all threads of `pool`, which only the calling thread may use meanwhile
+  static void RunOn(StdThreadPool& pool, int begin, int end, const std::function<void(int)>& f) {
+    if (end <= begin) {
+      return;
+    }
+    std::atomic<int> next(begin);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::function<void()> work = [&]() {
+      int i;
+      while ((i = next++) < end) {
+        try {
+          f(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          next = end;
+        }
+      }
+    };
+    pool.RunOnAll(work);
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+#if defined(SSHICM_USE_RCPPTHREAD)
+// Backend on an RcppThread pool that persists across calls (e.g. one per variable or per sshic()
+// call) and is only rebuilt when the thread count changes. As for StdThreadBackend, the loop body
+// is type-erased so that the process keeps a single pool. Pools are only created and used from
+// the calling R thread.
+struct RcppThreadBackend {
+  template <class F>
+  static void ParallelFor(int begin, int end, F f, int threads) {
+    Run(begin, end, std::function<void(int)>(f), threads);
+  }
+
+  static void Run(int begin, int end, const std::function<void(int)>& f, int threads) {
+    if (end <= begin) {
+      return;
+    }
+    static std::unique_ptr<RcppThread::ThreadPool> pool;
+    static int pool_threads = 0;
+    threads = ResolveThreadNumber(threads);
+    if (!pool || pool_threads != threads) {
+      if (pool) {
+        pool->join();
+      }
+      pool.reset(new RcppThread::ThreadPool(threads));
+      pool_threads = threads;
+    }
+    pool->parallelFor(begin, end, f, end - begin);
+    pool->wait();
+  }
+};
+#endif
+
+#if defined(SSHICM_PARALLEL_BACKEND)
+typedef SSHICM_PARALLEL_BACKEND ParallelBackend;
+#elif defined(SSHICM_USE_RCPPTHREAD)
+typedef RcppThreadBackend ParallelBackend;
+#else
+typedef StdThreadBackend ParallelBackend;
+#endif
+
+// Pool that the loops started from the calling thread run on, whatever backend is selected, or
+// none. Background jobs (see Job.h) set it on their own thread to a pool they own: they run off
+// the R thread, where RcppThread pools must not be used, and with a pool of their own they neither
+// wait for the loops of other jobs nor resize a pool that other jobs use
+inline StdThreadPool*& ParallelForPool() {
+  static thread_local StdThreadPool* pool = nullptr;
+  return pool;
+}
+
+// Run f(i) for i in [begin, end) on `threads` workers of the selected backend, or on all workers
+// of the calling thread's own pool when it has one
+template <class F>
+void ParallelFor(int begin, int end, F f, int threads) {
+  if (ParallelForPool()) {
+    StdThreadBackend::RunOn(*ParallelForPool(), begin, end, std::function<void(int)>(f));
+  } else {
+    ParallelBackend::ParallelFor(begin, end, f, threads);
+  }
+}
+
+// Run block(begin, end) over [0, count) split into contiguous blocks of batch_size iterations, or
+// into one block per worker when batch_size is 0, so that per-task overhead is paid per block
+template <class Block>
+void ParallelForBlocks(int count, int threads, int batch_size, Block block) {
+  if (count <= 0) {
+    return;
+  }
+  int worker_number = ResolveThreadNumber(threads);
+  int block_size = batch_size > 0 ? batch_size : (count + worker_number - 1) / worker_number;
+  int block_number = (count + block_size - 1) / block_size;
+  ParallelFor(0, block_number, [&](size_t b) {
+    int begin = static_cast<int>(b) * block_size;
+    int end = std::min(count, begin + block_size);
+    block(begin, end);
+  }, threads);
+}
+
+} // namespace sshicm
+
+#endif // ParallelFor_H
@@ -0,0 +1,62 @@
+#ifndef PermutationPlan_H
+#define PermutationPlan_H
+
+#include <vector>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include "PermutationRng.h"
+#include "ParallelFor.h"
+
+namespace sshicm {
+
+// Permutations of the rows of a data set of length n, generated once for a seed and kept for every
+// variable and call that permutes data of that length with that seed. Permutation k holds the row
+// indices that ShuffleInPlace with PermutationRng(seed, k) produces from 0, 1, ..., n - 1, so a
+// statistic evaluated on data[permutation[i]] is exactly the one evaluated on the data shuffled by
+// that generator, and results with and without a plan are identical. Stored plans cost
+// n * permutation_number ints, and save the generator and the random swaps of every shuffle.
+class PermutationPlan {
+public:
+  PermutationPlan(size_t n, unsigned int seed, int permutation_number, int threads = 0)
+    : n_(n), seed_(seed), permutation_number_(permutation_number) {
+    if (permutation_number < 1) {
+      throw std::invalid_argument("Number of permutations must be positive.");
+    }
+    rows_.resize(n * static_cast<size_t>(permutation_number));
+    ParallelFor(0, permutation_number, [&](size_t k) {
+      int* permutation = rows_.data() + k * n;
+      std::iota(permutation, permutation + n, 0);
+      PermutationRng rng(seed, k);
+      ShuffleInPlace(permutation, n, rng);
+    }, threads);
+  }
+
+  size_t size() const { return n_; }
+  unsigned int seed() const { return seed_; }
+  int permutation_number() const { return permutation_number_; }
+  size_t Bytes() const { return rows_.capacity() * sizeof(int); }
+
+  // Row indices of permutation k, or nullptr when the plan holds fewer permutations, in which case
+  // the caller generates it as usual
+  const int* Find(int k) const {
+    return k < permutation_number_ ? rows_.data() + static_cast<size_t>(k) * n_ : nullptr;
+  }
+
+private:
+  size_t n_;
+  unsigned int seed_;
+  int permutation_number_;
+  std::vector<int> rows_;
+};
+
+// Check that a plan (if any) was generated for data of length n with the given seed
+inline void CheckPermutationPlan(const PermutationPlan* plan, size_t n, unsigned int seed) {
+  if (plan && (plan->size() != n || plan->seed() != seed)) {
+    throw std::invalid_argument("Permutation plan does not match the length of d and the seed.");
+  }
+}
+
+} // namespace sshicm
+
+#endif // PermutationPlan_H
@@ -0,0 +1,76 @@
+#ifndef PermutationRng_H
+#define PermutationRng_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+namespace sshicm {
+
+// SplitMix64 finalizer: a bijective 64-bit mixing function
+inline uint64_t MixBits64(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// xoshiro256** generator keyed by (seed, stream), so that permutation i of a run can be generated
+// on any worker from (seed, i) alone; the 256-bit state is filled by SplitMix64 from a hash of the
+// key, which costs a few multiplications instead of the 2.5 KB state of std::mt19937
+class PermutationRng {
+public:
+  PermutationRng(uint64_t seed, uint64_t stream) {
+    uint64_t splitmix_state = MixBits64(MixBits64(seed) ^ stream);
+    for (int i = 0; i < 4; ++i) {
+      splitmix_state += 0x9e3779b97f4a7c15ULL;
+      state_[i] = MixBits64(splitmix_state);
+    }
+  }
+
+  uint64_t Next() {
+    uint64_t result = Rotate(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotate(state_[3], 45);
+    return result;
+  }
+
+  // Uniform integer in [0, range), range >= 1, by Lemire's multiply-and-reject method, which only
+  // divides in the rare case that the first draw falls into the biased region
+  uint32_t Bounded(uint32_t range) {
+    uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>(Next() >> 32)) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+      uint32_t threshold = (0u - range) % range;
+      while (low < threshold) {
+        product = static_cast<uint64_t>(static_cast<uint32_t>(Next() >> 32)) * range;
+        low = static_cast<uint32_t>(product);
+      }
+    }
+    return static_cast<uint32_t>(product >> 32);
+  }
+
+private:
+  static uint64_t Rotate(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  uint64_t state_[4];
+};
+
+// Fisher-Yates shuffle of data[0, n) drawing from rng
+template <class T>
+void ShuffleInPlace(T* data, size_t n, PermutationRng& rng) {
+  for (size_t i = n; i > 1; --i) {
+    size_t j = rng.Bounded(static_cast<uint32_t>(i));
+    std::swap(data[i - 1], data[j]);
+  }
+}
+
+} // namespace sshicm
+
+#endif // PermutationRng_H
@@ -0,0 +1,121 @@
+#ifndef PermutationTest_H
+#define PermutationTest_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace sshicm {
+
+// Whether the p-value estimate greater_count / permutation_count is clearly on one side of alpha,
+// i.e. alpha lies outside the Wilson score interval at z = 3.29 (99.9% two-sided)
+inline bool PValueSettled(int greater_count, int permutation_count, double alpha) {
+  const double z = 3.2905;
+  double n = permutation_count;
+  double denominator = n + z * z;
+  double center = (greater_count + z * z / 2) / denominator;
+  double half_width = z * std::sqrt(greater_count * (n - greater_count) / n + z * z / 4) / denominator;
+  return center + half_width < alpha || center - half_width > alpha;
+}
+
+// Number of permutations to run in the next round: everything at once, or for the sequential test
+// rounds of 128, 256, ... up to 4096 permutations, so that clear cases stop early and long runs
+// synchronise rarely
+inline int PermutationRoundSize(int done, int permutation_number, bool sequential) {
+  int remaining = permutation_number - done;
+  if (!sequential) {
+    return remaining;
+  }
+  int round_size = 128;
+  while (round_size < 4096 && round_size <= done) {
+    round_size *= 2;
+  }
+  return std::min(round_size, remaining);
+}
+
+// Run a permutation test for several statistics that share the same permutations, returning
+// {observed value, p-value, permutations used} for each statistic.
+//
+// evaluate_round(first, count, active, results) must store the value of statistic active[a] on
+// permutation first + k in results[k * active.size() + a]. Without the sequential test all
+// permutation_number permutations are evaluated in one round. With it, permutations run in rounds
+// and a statistic stops (Besag and Clifford, 1991) once exceed_threshold permutation values reach
+// the observed one, with p = exceed_threshold / permutations used, or once its p-value is clearly
+// above or below alpha. Stopping only depends on the permutation index order, so the result does
+// not depend on the number of threads. When permutation_values is given, it receives the values of
+// each statistic on the permutations it used, in permutation order, e.g. for TailPValue.
+template <class EvaluateRound>
+std::vector<std::vector<double>> RunPermutationTest(const std::vector<double>& observed,
+                                                    int permutation_number,
+                                                    bool sequential,
+                                                    int exceed_threshold,
+                                                    double alpha,
+                                                    EvaluateRound evaluate_round,
+                                                    std::vector<std::vector<double>>* permutation_values = nullptr) {
+  if (permutation_number < 1) {
+    throw std::invalid_argument("Number of permutations must be positive.");
+  }
+  if (sequential && (exceed_threshold < 1 || !(alpha > 0 && alpha < 1))) {
+    throw std::invalid_argument("Sequential test needs exceed_threshold >= 1 and 0 < alpha < 1.");
+  }
+
+  size_t statistic_number = observed.size();
+  std::vector<int> greater_count(statistic_number, 0);
+  std::vector<int> permutations_used(statistic_number, permutation_number);
+  std::vector<size_t> active(statistic_number);
+  for (size_t v = 0; v < statistic_number; ++v) {
+    active[v] = v;
+  }
+  if (permutation_values) {
+    permutation_values->assign(statistic_number, std::vector<double>());
+  }
+
+  std::vector<double> results;
+  int done = 0;
+  while (done < permutation_number && !active.empty()) {
+    int round_size = PermutationRoundSize(done, permutation_number, sequential);
+    results.assign(static_cast<size_t>(round_size) * active.size(), 0.0);
+    evaluate_round(done, round_size, active, results);
+
+    // Count exceedances in permutation order, stopping a statistic at its h-th exceedance
+    std::vector<size_t> still_active;
+    for (size_t a = 0; a < active.size(); ++a) {
+      size_t v = active[a];
+      bool stopped = false;
+      for (int k = 0; k < round_size && !stopped; ++k) {
+        if (permutation_values) {
+          (*permutation_values)[v].push_back(results[static_cast<size_t>(k) * active.size() + a]);
+        }
+        if (results[static_cast<size_t>(k) * active.size() + a] >= observed[v]) {
+          greater_count[v]++;
+          if (sequential && greater_count[v] == exceed_threshold) {
+            permutations_used[v] = done + k + 1;
+            stopped = true;
+          }
+        }
+      }
+      if (!stopped && sequential && done + round_size < permutation_number &&
+          PValueSettled(greater_count[v], done + round_size, alpha)) {
+        permutations_used[v] = done + round_size;
+        stopped = true;
+      }
+      if (!stopped) {
+        still_active.push_back(v);
+      }
+    }
+    active.swap(still_active);
+    done += round_size;
+  }
+
+  std::vector<std::vector<double>> result(statistic_number);
+  for (size_t v = 0; v < statistic_number; ++v) {
+    double p_value = static_cast<double>(greater_count[v]) / permutations_used[v];
+    result[v] = {observed[v], p_value, static_cast<double>(permutations_used[v])};
+  }
+  return result;
+}
+
+} // namespace sshicm
+
+#endif // PermutationTest_H
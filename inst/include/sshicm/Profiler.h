@@ -0,0 +1,153 @@
+#ifndef Profiler_H
+#define Profiler_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cstddef>
+
+namespace sshicm {
+
+// Phases of the permutation drivers that the profiler times. Phases that run inside the parallel
+// loops are summed over all threads, so they can exceed the wall-clock time of a call.
+enum ProfilePhase {
+  kProfileSetup,           // sorting d, recoding and indexing the stratifications
+  kProfileObserved,        // statistics of the unpermuted data
+  kProfileShuffle,         // generating the permutations
+  kProfileGroup,           // gathering the d values of each stratum (IC)
+  kProfileRelEntropy,      // bins, histograms and relative entropy of each stratum (IC)
+  kProfileTable,           // counting the joint table of d and s (IN)
+  kProfileEntropy,         // conditional entropy from the joint table (IN)
+  kProfileTest,            // permutation rounds as seen from the calling thread (wall clock)
+  kProfilePhaseNumber
+};
+
+inline const char* ProfilePhaseName(int phase) {
+  static const char* names[kProfilePhaseNumber] = {
+    "setup", "observed", "shuffle", "group", "relative_entropy", "table", "entropy", "permutation_rounds"
+  };
+  return names[phase];
+}
+
+// Measurements of one profiled call
+struct ProfileReport {
+  double wall_seconds = 0;
+  std::vector<double> phase_seconds = std::vector<double>(kProfilePhaseNumber, 0.0);
+  double permutations = 0;        // permutations generated
+  double evaluations = 0;         // statistics evaluated on permutations
+  double bytes_allocated = 0;     // bytes of the buffers the call allocated (sorted d, indexes, workspaces)
+  std::vector<double> thread_busy_seconds;
+  std::vector<std::vector<double>> stratum_seconds;       // [variable][stratum], IC only
+  std::vector<std::vector<double>> stratum_evaluations;   // [variable][stratum], IC only
+};
+
+// Profiler that does nothing: every call is an empty inline function, so code instantiated with it
+// compiles to the same loops as code without instrumentation. The permutation loops call
+// Checkpoint() before each permutation, where a profiler may stop the call (see JobProfiler)
+class NullProfiler {
+public:
+  typedef int Timer;
+
+  Timer Now() const { return 0; }
+  void AddPhase(ProfilePhase, Timer, Timer) {}
+  void AddStratum(size_t, size_t, Timer, Timer) {}
+  void CountPermutations(int) {}
+  void CountEvaluations(int) {}
+  void CountBytes(size_t) {}
+  void Checkpoint() const {}
+  NullProfiler Fork() const { return NullProfiler(); }
+  void Merge(const NullProfiler&, Timer) {}
+};
+
+// Profiler that accumulates timers and counters. Each parallel task works on a Fork() of the
+// profiler and merges it back once when it ends, so the hot loops never share or lock anything.
+class PhaseProfiler {
+public:
+  typedef std::chrono::steady_clock::time_point Timer;
+
+  PhaseProfiler() : shared_(new Shared()) {}
+
+  Timer Now() const { return std::chrono::steady_clock::now(); }
+
+  void AddPhase(ProfilePhase phase, Timer from, Timer to) {
+    report_.phase_seconds[phase] += Seconds(from, to);
+  }
+
+  void AddStratum(size_t variable, size_t stratum, Timer from, Timer to) {
+    Grow(report_.stratum_seconds, variable, stratum);
+    Grow(report_.stratum_evaluations, variable, stratum);
+    report_.stratum_seconds[variable][stratum] += Seconds(from, to);
+    report_.stratum_evaluations[variable][stratum] += 1;
+  }
+
+  void CountPermutations(int count) { report_.permutations += count; }
+  void CountEvaluations(int count) { report_.evaluations += count; }
+  void CountBytes(size_t bytes) { report_.bytes_allocated += bytes; }
+  void Checkpoint() const {}
+
+  PhaseProfiler Fork() const {
+    PhaseProfiler fork;
+    fork.shared_ = shared_;
+    return fork;
+  }
+
+  // Add a fork's measurements, counting the time since task_start as busy time of this thread
+  void Merge(const PhaseProfiler& fork, Timer task_start) {
+    double busy = Seconds(task_start, Now());
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    size_t slot = 0;
+    while (slot < shared_->threads.size() && shared_->threads[slot] != std::this_thread::get_id()) {
+      ++slot;
+    }
+    if (slot == shared_->threads.size()) {
+      shared_->threads.push_back(std::this_thread::get_id());
+      report_.thread_busy_seconds.push_back(0.0);
+    }
+    report_.thread_busy_seconds[slot] += busy;
+    for (int phase = 0; phase < kProfilePhaseNumber; ++phase) {
+      report_.phase_seconds[phase] += fork.report_.phase_seconds[phase];
+    }
+    report_.permutations += fork.report_.permutations;
+    report_.evaluations += fork.report_.evaluations;
+    report_.bytes_allocated += fork.report_.bytes_allocated;
+    for (size_t v = 0; v < fork.report_.stratum_seconds.size(); ++v) {
+      for (size_t k = 0; k < fork.report_.stratum_seconds[v].size(); ++k) {
+        Grow(report_.stratum_seconds, v, k);
+        Grow(report_.stratum_evaluations, v, k);
+        report_.stratum_seconds[v][k] += fork.report_.stratum_seconds[v][k];
+        report_.stratum_evaluations[v][k] += fork.report_.stratum_evaluations[v][k];
+      }
+    }
+  }
+
+  ProfileReport& Report() { return report_; }
+
+private:
+  struct Shared {
+    std::mutex mutex;
+    std::vector<std::thread::id> threads;
+  };
+
+  static double Seconds(Timer from, Timer to) {
+    return std::chrono::duration<double>(to - from).count();
+  }
+
+  static void Grow(std::vector<std::vector<double>>& table, size_t variable, size_t stratum) {
+    if (table.size() <= variable) {
+      table.resize(variable + 1);
+    }
+    if (table[variable].size() <= stratum) {
+      table[variable].resize(stratum + 1, 0.0);
+    }
+  }
+
+  ProfileReport report_;
+  std::shared_ptr<Shared> shared_;
+};
+
+} // namespace sshicm
+
+#endif // Profiler_H
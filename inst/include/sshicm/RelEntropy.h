@@ -0,0 +1,125 @@
+#ifndef RelEntropy_H
+#define RelEntropy_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include "HistogramDensityEst.h"
+#include "BinningRule.h"
+#include "Span.h"
+#include "Workspace.h"
+#include "HistogramKernels.h"
+
+namespace sshicm {
+
+// Relative Entropy computation against a Dvec that is already sorted in ascending order, with the
+// bins of the binning rule `Rule` (see BinningRule.h) and the histograms counted into the workspace
+template <class Rule>
+double RelEntropySortedRule(Span<double> DIvec,
+                            const SortedData& sorted_data,
+                            RelEntropyWorkspace& workspace) {
+  Span<double> sorted_Dvec = sorted_data.values;
+  if (DIvec.empty() || sorted_Dvec.empty()) {
+    throw std::invalid_argument("Input vectors must not be empty.");
+  }
+
+  // Step 1: Locate the values of Dvec within the range of DIvec by binary search
+  auto DI_range = std::minmax_element(DIvec.begin(), DIvec.end());
+  double min_DI = *DI_range.first;
+  double max_DI = *DI_range.second;
+  const double* sorted_begin = sorted_Dvec.data();
+  const double* sorted_end = sorted_begin + sorted_Dvec.size();
+  const double* filtered_begin = std::lower_bound(sorted_begin, sorted_end, min_DI);
+  const double* filtered_end = std::upper_bound(filtered_begin, sorted_end, max_DI);
+  if (filtered_begin >= filtered_end) {
+    throw std::invalid_argument("No elements in Dvec are within the range of DIvec.");
+  }
+
+  // Step 2: Derive the bins FD uses for the filtered Dvec; its range is read off the sorted ends
+  size_t filtered_count = filtered_end - filtered_begin;
+  if (filtered_count < 2) {
+    throw std::invalid_argument("Data size must be at least 2.");
+  }
+  int bin_count = Rule::Bins(sorted_data, filtered_begin - sorted_begin, filtered_end - sorted_begin);
+  double min_val = *filtered_begin;
+  double max_val = *(filtered_end - 1);
+  if (max_val == min_val) {
+    return 0.0; // Both densities are the same point mass
+  }
+  double bin_width = (max_val - min_val) / bin_count;
+
+  // Step 3: Compute density FD for the filtered Dvec from cumulative counts on the sorted array
+  std::vector<int>& FD_counts = workspace.FD_counts;
+  FD_counts.assign(bin_count, 0);
+  HistogramCountsSorted(filtered_begin, filtered_end, min_val, bin_width, bin_count, FD_counts.data());
+
+  // Step 4: Compute density FDI for DIvec on the same bins
+  std::vector<int>& FDI_counts = workspace.FDI_counts;
+  FDI_counts.assign(bin_count, 0);
+  if (min_DI >= min_val && max_DI <= max_val) {
+    HistogramCountUniform(DIvec.data(), DIvec.size(), min_val, bin_width, bin_count, FDI_counts.data());
+  } else {
+    for (double value : DIvec) {
+      if (value >= min_val && value <= max_val) {
+        FDI_counts[HistogramBinIndex(value, min_val, bin_width, bin_count)]++;
+      }
+    }
+  }
+
+  // Step 5: Compute relative entropy
+  double rel_entropy = 0.0;
+  for (int i = 0; i < bin_count; ++i) {
+    double fd = static_cast<double>(FD_counts[i]) / (filtered_count * bin_width);   // Density from FD
+    double fdi = static_cast<double>(FDI_counts[i]) / (DIvec.size() * bin_width);  // Density from FDI
+    if (fd > 0 && fdi > 0) { // Avoid log(0) and division by zero
+      rel_entropy += fdi * std::log(fdi / fd) * bin_width;
+    }
+  }
+
+  return rel_entropy;
+}
+
+// Relative Entropy computation against a Dvec that is already sorted in ascending order, counting
+// the histograms into the workspace
+inline double RelEntropySorted(Span<double> DIvec,
+                               Span<double> sorted_Dvec,
+                               const std::string& bin_method,
+                               RelEntropyWorkspace& workspace) {
+  SortedData sorted_data(sorted_Dvec);
+  switch (ParseBinningMethod(bin_method)) {
+  case kBinSturges:
+    return RelEntropySortedRule<SturgesRule>(DIvec, sorted_data, workspace);
+  case kBinSquareRoot:
+    return RelEntropySortedRule<SquareRootRule>(DIvec, sorted_data, workspace);
+  case kBinRice:
+    return RelEntropySortedRule<RiceRule>(DIvec, sorted_data, workspace);
+  case kBinScott:
+    return RelEntropySortedRule<ScottRule>(DIvec, sorted_data, workspace);
+  default:
+    return RelEntropySortedRule<FreedmanDiaconisRule>(DIvec, sorted_data, workspace);
+  }
+}
+
+// Relative Entropy computation against a Dvec that is already sorted in ascending order
+inline double RelEntropySorted(Span<double> DIvec,
+                               Span<double> sorted_Dvec,
+                               const std::string& bin_method) {
+  RelEntropyWorkspace workspace;
+  return RelEntropySorted(DIvec, sorted_Dvec, bin_method, workspace);
+}
+
+// Relative Entropy computation
+inline double RelEntropy(Span<double> DIvec,
+                         Span<double> Dvec,
+                         const std::string& bin_method) {
+  std::vector<double> sorted_Dvec(Dvec.begin(), Dvec.end());
+  std::sort(sorted_Dvec.begin(), sorted_Dvec.end());
+  return RelEntropySorted(DIvec, sorted_Dvec, bin_method);
+}
+
+} // namespace sshicm
+
+#endif // RelEntropy_H
@@ -0,0 +1,32 @@
+#ifndef Span_H
+#define Span_H
+
+#include <vector>
+#include <cstddef>
+
+namespace sshicm {
+
+// Non-owning read-only view of contiguous memory (pointer + length), e.g. the storage of an R
+// vector or a std::vector; the viewed memory must outlive the view and must not be resized
+template <class T>
+class Span {
+public:
+  Span() : data_(nullptr), size_(0) {}
+  Span(const T* data, size_t size) : data_(data), size_(size) {}
+  Span(const std::vector<T>& data) : data_(data.data()), size_(data.size()) {}
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+  const T* data_;
+  size_t size_;
+};
+
+} // namespace sshicm
+
+#endif // Span_H
@@ -0,0 +1,96 @@
+#ifndef StratumIndex_H
+#define StratumIndex_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include "Span.h"
+
+namespace sshicm {
+
+// Rows of each stratum of a stratification, with the strata in ascending order of their values and
+// the rows of a stratum in their original order: stratum k holds rows[offsets[k], offsets[k + 1])
+struct StratumIndex {
+  std::vector<int> offsets;
+  std::vector<int> rows;
+
+  size_t stratum_number() const { return offsets.size() - 1; }
+  int stratum_size(size_t k) const { return offsets[k + 1] - offsets[k]; }
+};
+
+// Scratch buffers of BuildStratumIndex, for callers that index many small stratifications in turn
+struct StratumIndexBuffers {
+  std::vector<int> codes;
+  std::vector<int> unique_values;
+  std::vector<int> positions;
+  std::vector<int> next;
+};
+
+// Group the rows of s by stratum with a counting sort into `index`, reusing its storage and that of
+// the buffers
+inline void BuildStratumIndex(Span<int> s, StratumIndex& index, StratumIndexBuffers& buffers) {
+  size_t n = s.size();
+
+  // Step 1: Code each row by the rank of its stratum value; codes 1..K with K <= n (as produced by
+  // as.integer(as.factor())) are used directly, anything else is ranked by binary search
+  std::vector<int>& codes = buffers.codes;
+  codes.resize(n);
+  int code_number = 0;
+  bool dense = true;
+  for (size_t i = 0; i < n && dense; ++i) {
+    dense = s[i] >= 1 && static_cast<size_t>(s[i]) <= n;
+    code_number = std::max(code_number, s[i]);
+  }
+  if (dense) {
+    for (size_t i = 0; i < n; ++i) {
+      codes[i] = s[i] - 1;
+    }
+  } else {
+    std::vector<int>& unique_values = buffers.unique_values;
+    unique_values.assign(s.begin(), s.end());
+    std::sort(unique_values.begin(), unique_values.end());
+    unique_values.erase(std::unique(unique_values.begin(), unique_values.end()), unique_values.end());
+    code_number = unique_values.size();
+    for (size_t i = 0; i < n; ++i) {
+      codes[i] = std::lower_bound(unique_values.begin(), unique_values.end(), s[i]) - unique_values.begin();
+    }
+  }
+
+  // Step 2: Count the rows of each code and turn the counts into starting positions
+  std::vector<int>& positions = buffers.positions;
+  positions.assign(code_number + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    positions[codes[i] + 1]++;
+  }
+  for (int k = 0; k < code_number; ++k) {
+    positions[k + 1] += positions[k];
+  }
+
+  // Step 3: Place the rows, keeping their original order within each stratum
+  index.rows.resize(n);
+  std::vector<int>& next = buffers.next;
+  next = positions;
+  for (size_t i = 0; i < n; ++i) {
+    index.rows[next[codes[i]]++] = static_cast<int>(i);
+  }
+
+  // Step 4: Keep the offsets of the strata that actually occur
+  index.offsets.assign(1, 0);
+  for (int k = 0; k < code_number; ++k) {
+    if (positions[k + 1] > positions[k]) {
+      index.offsets.push_back(positions[k + 1]);
+    }
+  }
+}
+
+// Group the rows of s by stratum with a counting sort
+inline StratumIndex BuildStratumIndex(Span<int> s) {
+  StratumIndex index;
+  StratumIndexBuffers buffers;
+  BuildStratumIndex(s, index, buffers);
+  return index;
+}
+
+} // namespace sshicm
+
+#endif // StratumIndex_H
@@ -0,0 +1,331 @@
+#ifndef StreamingIC_H
+#define StreamingIC_H
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include "HistogramDensityEst.h"
+#include "BinningRule.h"
+#include "Span.h"
+
+namespace sshicm {
+
+// Streaming IC_SSH for data that do not fit in memory. The data are read in three passes, each in
+// chunks of any size and order, and every pass accumulates a state of O(K) or O(K * bins) for K
+// strata that merges with the states of other chunks or workers:
+//   1. ICStreamRanges:     row count, minimum and maximum of d in each stratum
+//   2. ICStreamCounts:     number of d values in the range of each stratum (and for Scott their
+//                          sums), from which the bins RelEntropy uses for the stratum follow
+//   3. ICStreamHistograms: histograms of d in the range of each stratum and of the stratum itself
+//                          on those bins
+// Three passes are needed because the bin count of a stratum depends on how many d values fall
+// in its range, which is only known once the range is. The histograms equal the ones IC_SSH
+// counts, so IC_SSH_Stream() agrees with IC_SSH, except that Scott's rule sums the values in
+// chunk order rather than in sorted order. FreedmanDiaconis needs the quartiles of every range
+// and is not supported.
+
+// Row count and range of d in one stratum
+struct StratumRange {
+  int64_t count;
+  double min;
+  double max;
+};
+
+// Pass 1: row count and range of d in every stratum
+class ICStreamRanges {
+public:
+  ICStreamRanges() : total_count_(0) {}
+
+  void Add(Span<double> d, Span<int> s) {
+    if (s.size() != d.size()) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+    for (size_t i = 0; i < d.size(); ++i) {
+      AddRange(s[i], StratumRange{1, d[i], d[i]});
+    }
+    total_count_ += d.size();
+  }
+
+  void Merge(const ICStreamRanges& other) {
+    for (const auto& stratum : other.strata_) {
+      AddRange(stratum.first, stratum.second);
+    }
+    total_count_ += other.total_count_;
+  }
+
+  int64_t total_count() const { return total_count_; }
+
+  // Strata in ascending order of their values, as in StratumIndex
+  const std::map<int, StratumRange>& strata() const { return strata_; }
+
+private:
+  void AddRange(int s_value, const StratumRange& range) {
+    auto found = strata_.find(s_value);
+    if (found == strata_.end()) {
+      strata_.insert(std::make_pair(s_value, range));
+      return;
+    }
+    found->second.count += range.count;
+    found->second.min = std::min(found->second.min, range.min);
+    found->second.max = std::max(found->second.max, range.max);
+  }
+
+  std::map<int, StratumRange> strata_;
+  int64_t total_count_;
+};
+
+// Cell of a value among the sorted distinct range ends: 2i + 1 for the end ends[i], 2i for the
+// values between ends[i - 1] and ends[i]
+inline size_t StreamCell(const std::vector<double>& ends, double value) {
+  size_t i = std::upper_bound(ends.begin(), ends.end(), value) - ends.begin();
+  return (i > 0 && ends[i - 1] == value) ? 2 * i - 1 : 2 * i;
+}
+
+// Pass 2: count of d (and for Scott its sum and sum of squares) in the range of every stratum.
+// The m distinct range ends split the line into 2m + 1 cells (each end, and the open intervals
+// around them); a value is counted in its cell found by binary search, and the range of a stratum
+// is a run of cells, so the pass costs O(log K) per value and O(K) memory. As in SortedData, the
+// sums are of the values shifted by the lower end of their cell, so that they stay small whatever
+// the offset of d
+class ICStreamCounts {
+public:
+  ICStreamCounts(const ICStreamRanges& ranges, const std::string& bin_method)
+    : method_(ParseBinningMethod(bin_method)) {
+    if (method_ == kBinFreedmanDiaconis) {
+      throw std::invalid_argument("FreedmanDiaconis binning is not supported by streaming IC_SSH.");
+    }
+    for (const auto& stratum : ranges.strata()) {
+      ends_.push_back(stratum.second.min);
+      ends_.push_back(stratum.second.max);
+    }
+    std::sort(ends_.begin(), ends_.end());
+    ends_.erase(std::unique(ends_.begin(), ends_.end()), ends_.end());
+    cell_count_.assign(2 * ends_.size() + 1, 0);
+    if (method_ == kBinScott) {
+      cell_sum_.assign(cell_count_.size(), 0.0);
+      cell_square_sum_.assign(cell_count_.size(), 0.0);
+    }
+  }
+
+  void Add(Span<double> d) {
+    bool scott = !cell_sum_.empty();
+    for (double value : d) {
+      size_t cell = Cell(value);
+      cell_count_[cell]++;
+      if (scott) {
+        double shifted = value - CellShift(cell);
+        cell_sum_[cell] += shifted;
+        cell_square_sum_[cell] += shifted * shifted;
+      }
+    }
+  }
+
+  void Merge(const ICStreamCounts& other) {
+    if (other.ends_ != ends_ || other.method_ != method_) {
+      throw std::invalid_argument("Streaming states of different ranges or bin methods cannot be merged.");
+    }
+    for (size_t c = 0; c < cell_count_.size(); ++c) {
+      cell_count_[c] += other.cell_count_[c];
+    }
+    for (size_t c = 0; c < cell_sum_.size(); ++c) {
+      cell_sum_[c] += other.cell_sum_[c];
+      cell_square_sum_[c] += other.cell_square_sum_[c];
+    }
+  }
+
+  size_t Cell(double value) const { return StreamCell(ends_, value); }
+
+  size_t cell_number() const { return cell_count_.size(); }
+  const std::vector<double>& ends() const { return ends_; }
+
+  // Number of d values in the range of a stratum, and the bin count that CalculateBinsSorted
+  // derives for them. For Scott the sums of the cells are moved to the common shift range.min:
+  // with delta the distance between the two shifts, sum(x - a + delta) and sum((x - a + delta)^2)
+  // follow from the count and the sums shifted by a
+  int RangeBins(const StratumRange& range, int64_t& count) const {
+    size_t first = Cell(range.min);
+    size_t last = Cell(range.max);
+    count = 0;
+    double sum = 0.0;
+    double square_sum = 0.0;
+    for (size_t c = first; c <= last; ++c) {
+      count += cell_count_[c];
+      if (!cell_sum_.empty() && cell_count_[c] > 0) {
+        double delta = CellShift(c) - range.min;
+        sum += cell_sum_[c] + cell_count_[c] * delta;
+        square_sum += cell_square_sum_[c] + 2 * delta * cell_sum_[c] + cell_count_[c] * delta * delta;
+      }
+    }
+    if (count < 2) {
+      throw std::invalid_argument("Data size must be at least 2.");
+    }
+    int bins = CalculateBinsFromSize(static_cast<size_t>(count), method_);
+    if (bins > 0) {
+      return bins;
+    }
+    // Moments of the shifted values, which have the same variance
+    double mean = sum / count;
+    double variance = square_sum / count - mean * mean;
+    double bin_width = 3.49 * std::sqrt(variance) / std::cbrt(static_cast<double>(count));
+    return BinsFromWidth(range.max - range.min, bin_width);
+  }
+
+private:
+  // Lower end of a cell: ends[i] for the cell 2i + 1 of that end and ends[i - 1] for the interval
+  // 2i after it; values outside all ranges do not occur, but cell 0 is shifted by ends[0]
+  double CellShift(size_t cell) const {
+    return ends_.empty() ? 0.0 : ends_[cell == 0 ? 0 : (cell - 1) / 2];
+  }
+
+  BinningMethod method_;
+  std::vector<double> ends_;
+  std::vector<int64_t> cell_count_;
+  std::vector<double> cell_sum_;
+  std::vector<double> cell_square_sum_;
+};
+
+// Pass 3: for every stratum, the histogram of the d values in its range (FD) and of its own values
+// (FDI) on the bins RelEntropy uses for it. Each cell of pass 2 keeps the strata whose range
+// covers it, so a value is only binned for the strata it belongs to
+class ICStreamHistograms {
+public:
+  ICStreamHistograms(const ICStreamRanges& ranges, const ICStreamCounts& counts)
+    : total_count_(ranges.total_count()), ends_(counts.ends()) {
+    // Step 1: Fix the bins of every stratum and lay out its histograms
+    size_t offset = 0;
+    for (const auto& stratum : ranges.strata()) {
+      StreamStratum current;
+      current.range = stratum.second;
+      current.bins = counts.RangeBins(stratum.second, current.filtered_count);
+      if (current.range.max == current.range.min) {
+        current.bins = 0; // Both densities are the same point mass
+      }
+      current.bin_width = current.bins > 0 ? (current.range.max - current.range.min) / current.bins : 0.0;
+      current.offset = offset;
+      offset += current.bins;
+      stratum_position_[stratum.first] = strata_.size();
+      strata_.push_back(current);
+    }
+    FD_counts_.assign(offset, 0);
+    FDI_counts_.assign(offset, 0);
+
+    // Step 2: List the strata covering each cell, in CSR layout
+    std::vector<size_t> cover_count(counts.cell_number() + 1, 0);
+    for (const StreamStratum& stratum : strata_) {
+      if (stratum.bins > 0) {
+        for (size_t c = counts.Cell(stratum.range.min); c <= counts.Cell(stratum.range.max); ++c) {
+          cover_count[c + 1]++;
+        }
+      }
+    }
+    for (size_t c = 0; c + 1 < cover_count.size(); ++c) {
+      cover_count[c + 1] += cover_count[c];
+    }
+    cover_offsets_ = cover_count;
+    cover_strata_.resize(cover_offsets_.back());
+    for (size_t k = 0; k < strata_.size(); ++k) {
+      if (strata_[k].bins > 0) {
+        for (size_t c = counts.Cell(strata_[k].range.min); c <= counts.Cell(strata_[k].range.max); ++c) {
+          cover_strata_[cover_count[c]++] = static_cast<int>(k);
+        }
+      }
+    }
+  }
+
+  void Add(Span<double> d, Span<int> s) {
+    if (s.size() != d.size()) {
+      throw std::invalid_argument("Vectors s and d must have the same length.");
+    }
+    int last_s_value = 0;
+    size_t last_position = strata_.size();
+    for (size_t i = 0; i < d.size(); ++i) {
+      double value = d[i];
+
+      // Step 1: Count the value into FD of every stratum whose range holds it
+      size_t cell = StreamCell(ends_, value);
+      for (size_t j = cover_offsets_[cell]; j < cover_offsets_[cell + 1]; ++j) {
+        const StreamStratum& stratum = strata_[cover_strata_[j]];
+        FD_counts_[stratum.offset + HistogramBinIndex(value, stratum.range.min, stratum.bin_width, stratum.bins)]++;
+      }
+
+      // Step 2: Count the value into FDI of its own stratum
+      if (last_position == strata_.size() || s[i] != last_s_value) {
+        auto found = stratum_position_.find(s[i]);
+        if (found == stratum_position_.end()) {
+          throw std::invalid_argument("Stratum not seen in the first pass.");
+        }
+        last_s_value = s[i];
+        last_position = found->second;
+      }
+      const StreamStratum& own = strata_[last_position];
+      if (own.bins > 0) {
+        FDI_counts_[own.offset + HistogramBinIndex(value, own.range.min, own.bin_width, own.bins)]++;
+      }
+    }
+  }
+
+  void Merge(const ICStreamHistograms& other) {
+    if (other.ends_ != ends_ || other.FD_counts_.size() != FD_counts_.size()) {
+      throw std::invalid_argument("Streaming states of different ranges or bin methods cannot be merged.");
+    }
+    for (size_t b = 0; b < FD_counts_.size(); ++b) {
+      FD_counts_[b] += other.FD_counts_[b];
+      FDI_counts_[b] += other.FDI_counts_[b];
+    }
+  }
+
+  // Relative entropy of stratum k (in ascending order of the stratum values), as RelEntropySorted
+  // computes it from the same histograms
+  double RelEntropy(size_t k) const {
+    const StreamStratum& stratum = strata_[k];
+    double rel_entropy = 0.0;
+    for (int i = 0; i < stratum.bins; ++i) {
+      double fd = static_cast<double>(FD_counts_[stratum.offset + i]) / (stratum.filtered_count * stratum.bin_width);
+      double fdi = static_cast<double>(FDI_counts_[stratum.offset + i]) / (stratum.range.count * stratum.bin_width);
+      if (fd > 0 && fdi > 0) {
+        rel_entropy += fdi * std::log(fdi / fd) * stratum.bin_width;
+      }
+    }
+    return rel_entropy;
+  }
+
+  size_t stratum_number() const { return strata_.size(); }
+  int64_t stratum_size(size_t k) const { return strata_[k].range.count; }
+  int64_t total_count() const { return total_count_; }
+
+private:
+  struct StreamStratum {
+    StratumRange range;
+    int64_t filtered_count;
+    int bins;
+    double bin_width;
+    size_t offset;
+  };
+
+  int64_t total_count_;
+  std::vector<double> ends_;
+  std::vector<StreamStratum> strata_;
+  std::map<int, size_t> stratum_position_;
+  std::vector<size_t> cover_offsets_;
+  std::vector<int> cover_strata_;
+  std::vector<int64_t> FD_counts_;
+  std::vector<int64_t> FDI_counts_;
+};
+
+// Compute IC_SSH from the histograms of the last streaming pass
+inline double IC_SSH_Stream(const ICStreamHistograms& histograms) {
+  double IC = 0.0;
+  for (size_t k = 0; k < histograms.stratum_number(); ++k) {
+    double probability = static_cast<double>(histograms.stratum_size(k)) / histograms.total_count();
+    IC += probability * (std::atan(histograms.RelEntropy(k)) / (M_PI / 2));
+  }
+  return IC;
+}
+
+} // namespace sshicm
+
+#endif // StreamingIC_H
@@ -0,0 +1,205 @@
+#ifndef TailPValue_H
+#define TailPValue_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include "PermutationRng.h"
+#include "ParallelFor.h"
+
+namespace sshicm {
+
+// Tail-extrapolated permutation p-values (Knijnenburg et al., 2009). When fewer than
+// kTailMinExceedances permutation values reach the observed value, the p-value estimate
+// exceedances / permutations is coarse, so a generalized Pareto distribution (GPD) is fitted to the
+// kTailMaxSize largest permutation values above a threshold t and
+//   p = tail_size / permutations * (1 - F_GPD(observed - t)).
+// A fit is accepted when an Anderson-Darling test does not reject it at kTailGofAlpha; otherwise
+// the tail is shrunk by kTailSizeStep and refitted, down to kTailMinSize values.
+const int kTailMinExceedances = 10;
+const int kTailMaxSize = 250;
+const int kTailMinSize = 20;
+const int kTailSizeStep = 10;
+const double kTailGofAlpha = 0.05;
+const int kTailBootstrapNumber = 99;
+
+// Generalized Pareto distribution with F(z) = 1 - (1 + shape * z / scale)^(-1 / shape) for z >= 0
+struct GPDFit {
+  double shape;
+  double scale;
+};
+
+inline double GPDUpperTail(const GPDFit& fit, double z) {
+  if (z <= 0) {
+    return 1.0;
+  }
+  if (std::fabs(fit.shape) < 1e-12) {
+    return std::exp(-z / fit.scale);
+  }
+  double base = 1.0 + fit.shape * z / fit.scale;
+  if (base <= 0) {
+    return 0.0; // Beyond the upper end point of a bounded tail
+  }
+  return std::exp(-std::log(base) / fit.shape);
+}
+
+// Fit a GPD to positive exceedances sorted in ascending order, by the empirical Bayes estimator of
+// Zhang and Stephens (2009), which needs no iterations and is defined for every shape. Returns
+// false when the exceedances are degenerate (e.g. too many ties at the threshold)
+inline bool FitGPD(const std::vector<double>& sorted_z, GPDFit& fit) {
+  size_t n = sorted_z.size();
+  double quartile = sorted_z[static_cast<size_t>(std::floor(n / 4.0 + 0.5)) - 1];
+  if (!(quartile > 0) || !(sorted_z.back() > 0)) {
+    return false;
+  }
+
+  // Step 1: Profile log-likelihood on a grid of theta = -shape / scale
+  int m = 30 + static_cast<int>(std::sqrt(static_cast<double>(n)));
+  std::vector<double> theta(m), log_likelihood(m);
+  for (int j = 0; j < m; ++j) {
+    theta[j] = 1.0 / sorted_z.back() + (1.0 - std::sqrt(m / (j + 0.5))) / (3.0 * quartile);
+    double k = 0.0;
+    for (double z : sorted_z) {
+      k += std::log1p(-theta[j] * z);
+    }
+    k /= n;
+    log_likelihood[j] = n * (std::log(-theta[j] / k) - k - 1.0);
+  }
+
+  // Step 2: Average theta over the grid, weighted by the normalized likelihood
+  double theta_hat = 0.0;
+  for (int j = 0; j < m; ++j) {
+    double weight_inverse = 0.0;
+    for (int i = 0; i < m; ++i) {
+      weight_inverse += std::exp(log_likelihood[i] - log_likelihood[j]);
+    }
+    theta_hat += theta[j] / weight_inverse;
+  }
+
+  // Step 3: Shape and scale at theta_hat
+  double k = 0.0;
+  for (double z : sorted_z) {
+    k += std::log1p(-theta_hat * z);
+  }
+  k /= n;
+  fit.shape = k;
+  fit.scale = -k / theta_hat;
+  if (!(fit.scale > 0) || !std::isfinite(fit.shape)) {
+    return false;
+  }
+  return true;
+}
+
+// Anderson-Darling statistic of exceedances sorted in ascending order against a fitted GPD
+inline double GPDAndersonDarling(const std::vector<double>& sorted_z, const GPDFit& fit) {
+  const double floor_probability = 1e-12;
+  size_t n = sorted_z.size();
+  double sum = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    double lower = 1.0 - GPDUpperTail(fit, sorted_z[i]);
+    double upper = GPDUpperTail(fit, sorted_z[n - 1 - i]);
+    lower = std::min(std::max(lower, floor_probability), 1.0 - floor_probability);
+    upper = std::min(std::max(upper, floor_probability), 1.0 - floor_probability);
+    sum += (2.0 * i + 1.0) * (std::log(lower) + std::log(upper));
+  }
+  return -static_cast<double>(n) - sum / n;
+}
+
+// Goodness-of-fit p-value of a GPD fitted to sorted_z, by parametric bootstrap of the
+// Anderson-Darling statistic with both parameters re-estimated on each sample
+inline double GPDGoodnessOfFit(const std::vector<double>& sorted_z, const GPDFit& fit, PermutationRng& rng) {
+  double observed = GPDAndersonDarling(sorted_z, fit);
+  size_t n = sorted_z.size();
+  std::vector<double> sample(n);
+  int reached = 0;
+  for (int b = 0; b < kTailBootstrapNumber; ++b) {
+    for (size_t i = 0; i < n; ++i) {
+      double u = (rng.Next() >> 11) * (1.0 / 9007199254740992.0);
+      sample[i] = std::fabs(fit.shape) < 1e-12 ? -fit.scale * std::log1p(-u) :
+        fit.scale / fit.shape * std::expm1(-fit.shape * std::log1p(-u));
+    }
+    std::sort(sample.begin(), sample.end());
+    GPDFit sample_fit;
+    if (!FitGPD(sample, sample_fit) || GPDAndersonDarling(sample, sample_fit) >= observed) {
+      reached++;
+    }
+  }
+  return (reached + 1.0) / (kTailBootstrapNumber + 1.0);
+}
+
+// Tail p-value of an observed statistic from its permutation values: {p-value, goodness-of-fit
+// p-value}. With at least kTailMinExceedances values reaching the observed one the permutation
+// p-value is kept and the goodness of fit is NaN; when no tail size gives an accepted fit the
+// permutation p-value is kept with the best goodness of fit found. `key` keys the bootstrap (see
+// TailBootstrapKey)
+inline std::vector<double> TailPValue(std::vector<double> values, double observed, uint64_t key) {
+  size_t permutation_count = values.size();
+  size_t exceedances = std::count_if(values.begin(), values.end(), [&](double value) {
+    return value >= observed;
+  });
+  double permutation_p = permutation_count > 0 ? static_cast<double>(exceedances) / permutation_count : 1.0;
+  if (exceedances >= static_cast<size_t>(kTailMinExceedances) ||
+      permutation_count < static_cast<size_t>(4 * kTailMinSize)) {
+    return {permutation_p, std::numeric_limits<double>::quiet_NaN()};
+  }
+
+  // Values in descending order, so that the tail of size N is values[0, N)
+  std::sort(values.begin(), values.end(), std::greater<double>());
+  int tail_size = static_cast<int>(std::min<size_t>(kTailMaxSize, permutation_count / 4));
+  double best_gof = 0.0;
+  for (; tail_size >= kTailMinSize; tail_size -= kTailSizeStep) {
+    double threshold = (values[tail_size - 1] + values[tail_size]) / 2;
+    std::vector<double> sorted_z(tail_size);
+    for (int i = 0; i < tail_size; ++i) {
+      sorted_z[tail_size - 1 - i] = values[i] - threshold;
+    }
+    GPDFit fit;
+    if (!FitGPD(sorted_z, fit)) {
+      continue;
+    }
+    PermutationRng rng(key, static_cast<uint64_t>(tail_size));
+    double gof = GPDGoodnessOfFit(sorted_z, fit, rng);
+    if (gof > kTailGofAlpha) {
+      double tail_p = static_cast<double>(tail_size) / permutation_count * GPDUpperTail(fit, observed - threshold);
+      return {tail_p, gof};
+    }
+    best_gof = std::max(best_gof, gof);
+  }
+  return {permutation_p, best_gof};
+}
+
+// Key of the bootstrap of a variable: the seed of the call and the bits of its observed value,
+// which no permutation changes, so that a variable gets the same tail p-value whether it is tested
+// alone, in a batch at any position or in a job
+inline uint64_t TailBootstrapKey(unsigned int seed, double observed) {
+  if (observed == 0) {
+    observed = 0.0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &observed, sizeof(bits));
+  return MixBits64(seed) ^ bits;
+}
+
+// Append {tail p-value, goodness of fit} to each result {observed value, p-value, permutations
+// used} of RunPermutationTest, from the permutation values it kept; `seed` is the seed of the
+// call, and the fits run on `threads` workers
+inline void AppendTailPValues(std::vector<std::vector<double>>& result,
+                              const std::vector<std::vector<double>>& permutation_values,
+                              unsigned int seed,
+                              int threads) {
+  std::vector<std::vector<double>> tail(result.size());
+  ParallelFor(0, static_cast<int>(result.size()), [&](size_t v) {
+    tail[v] = TailPValue(permutation_values[v], result[v][0], TailBootstrapKey(seed, result[v][0]));
+  }, threads);
+  for (size_t v = 0; v < result.size(); ++v) {
+    result[v].insert(result[v].end(), tail[v].begin(), tail[v].end());
+  }
+}
+
+} // namespace sshicm
+
+#endif // TailPValue_H
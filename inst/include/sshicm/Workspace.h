@@ -0,0 +1,96 @@
+#ifndef Workspace_H
+#define Workspace_H
+
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace sshicm {
+
+// Scratch buffers reused across permutations by one worker. They are sized when a worker starts
+// and only grow when a larger histogram is needed, so evaluating a permutation does not allocate.
+
+// Bin counts of the two densities compared by RelEntropy
+struct RelEntropyWorkspace {
+  std::vector<int> FD_counts;
+  std::vector<int> FDI_counts;
+};
+
+// Buffers of IC_SSH: the permuted row indices and the d values of one stratum
+struct ICWorkspace {
+  std::vector<int> permutation;
+  std::vector<double> stratum_values;
+  RelEntropyWorkspace rel_entropy;
+
+  ICWorkspace() {}
+  explicit ICWorkspace(size_t n) : permutation(n) {
+    stratum_values.reserve(n);
+  }
+
+  size_t Bytes() const {
+    return permutation.capacity() * sizeof(int) + stratum_values.capacity() * sizeof(double) +
+      (rel_entropy.FD_counts.capacity() + rel_entropy.FDI_counts.capacity()) * sizeof(int);
+  }
+};
+
+// Buffers of IN_SSH: the permuted codes of d (in the type they are packed in, see PackedCodes.h),
+// the flat joint table of dense stratifications, and for the other stratifications the per-stratum
+// d counts (kept at zero between strata) together with the codes counted in the current stratum
+template <class Code>
+struct INWorkspaceT {
+  std::vector<Code> permuted_d;
+  std::vector<int> joint_frequency;
+  std::vector<int> d_count;
+  std::vector<int> touched_codes;
+
+  INWorkspaceT() {}
+  INWorkspaceT(size_t n, size_t max_cells, int d_levels)
+    : permuted_d(n), joint_frequency(max_cells), d_count(d_levels, 0), touched_codes(d_levels) {}
+
+  size_t Bytes() const {
+    return permuted_d.capacity() * sizeof(Code) +
+      (joint_frequency.capacity() + d_count.capacity() + touched_codes.capacity()) * sizeof(int);
+  }
+};
+
+typedef INWorkspaceT<int> INWorkspace;
+
+// Workspaces checked out by the tasks of a parallel loop and returned when a task ends. No more
+// workspaces are created than tasks run at the same time, and each one is reused for the whole call
+template <class T>
+class WorkspacePool {
+public:
+  T& Acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      all_.emplace_back(new T());
+      return *all_.back();
+    }
+    T* workspace = free_.back();
+    free_.pop_back();
+    return *workspace;
+  }
+
+  void Release(T& workspace) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(&workspace);
+  }
+
+  // Visit every workspace created so far; only call this while no task is running
+  template <class F>
+  void ForEach(F f) const {
+    for (const std::unique_ptr<T>& workspace : all_) {
+      f(*workspace);
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<T>> all_;
+  std::vector<T*> free_;
+};
+
+} // namespace sshicm
+
+#endif // Workspace_H
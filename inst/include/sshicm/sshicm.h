@@ -0,0 +1,35 @@
+#ifndef sshicm_H
+#define sshicm_H
+
+// Header-only core of the sshicm package: information consistency-based measures of spatial
+// stratified heterogeneity (IC for continuous, IN for discrete target variables) and their
+// permutation tests. It only needs a C++11 compiler and threads; see ParallelFor.h for the
+// choice of parallel backend.
+
+#include "Span.h"
+#include "HistogramKernels.h"
+#include "BinningRule.h"
+#include "HistogramDensityEst.h"
+#include "RelEntropy.h"
+#include "StratumIndex.h"
+#include "PackedCodes.h"
+#include "Workspace.h"
+#include "PermutationRng.h"
+#include "PermutationPlan.h"
+#include "PermutationTest.h"
+#include "AsymptoticTest.h"
+#include "TailPValue.h"
+#include "ParallelFor.h"
+#include "Profiler.h"
+#include "IC_SSH.h"
+#include "IN_SSH.h"
+#include "ContingencyTable.h"
+#include "StreamingIC.h"
+#include "Breakpoints.h"
+#include "Interaction.h"
+#include "MultiResponse.h"
+#include "Job.h"
+#include "KdTree.h"
+#include "LocalSSH.h"
+
+#endif // sshicm_H
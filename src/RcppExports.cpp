@@ -24,8 +24,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // RcppINSSHICM
-Rcpp::NumericVector RcppINSSHICM(Rcpp::IntegerVector d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number);
-RcppExport SEXP _sshicm_RcppINSSHICM(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP) {
+Rcpp::NumericVector RcppINSSHICM(Rcpp::IntegerVector d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool profile, std::string pvalue, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppINSSHICM(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP profileSEXP, SEXP pvalueSEXP, SEXP tailSEXP, SEXP planSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -33,7 +33,16 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type s(sSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
     Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
-    rcpp_result_gen = Rcpp::wrap(RcppINSSHICM(d, s, seed, permutation_number));
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< std::string >::type pvalue(pvalueSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHICM(d, s, seed, permutation_number, sequential, exceed_threshold, alpha, threads, batch_size, profile, pvalue, tail, plan));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -51,8 +60,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // RcppICSSHICM
-Rcpp::NumericVector RcppICSSHICM(Rcpp::NumericVector d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number, std::string bin_method);
-RcppExport SEXP _sshicm_RcppICSSHICM(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP) {
+Rcpp::NumericVector RcppICSSHICM(Rcpp::NumericVector d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number, std::string bin_method, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool profile, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppICSSHICM(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP profileSEXP, SEXP tailSEXP, SEXP planSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -61,16 +70,372 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
     Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
     Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
-    rcpp_result_gen = Rcpp::wrap(RcppICSSHICM(d, s, seed, permutation_number, bin_method));
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHICM(d, s, seed, permutation_number, bin_method, sequential, exceed_threshold, alpha, threads, batch_size, profile, tail, plan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHICMBatch
+Rcpp::NumericMatrix RcppINSSHICMBatch(Rcpp::IntegerVector d, Rcpp::List s, unsigned int seed, int permutation_number, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool profile, std::string pvalue, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppINSSHICMBatch(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP profileSEXP, SEXP pvalueSEXP, SEXP tailSEXP, SEXP planSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< std::string >::type pvalue(pvalueSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHICMBatch(d, s, seed, permutation_number, sequential, exceed_threshold, alpha, threads, batch_size, profile, pvalue, tail, plan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHICMBatch
+Rcpp::NumericMatrix RcppICSSHICMBatch(Rcpp::NumericVector d, Rcpp::List s, unsigned int seed, int permutation_number, std::string bin_method, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool profile, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppICSSHICMBatch(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP profileSEXP, SEXP tailSEXP, SEXP planSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type profile(profileSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHICMBatch(d, s, seed, permutation_number, bin_method, sequential, exceed_threshold, alpha, threads, batch_size, profile, tail, plan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHTable
+Rcpp::NumericMatrix RcppINSSHTable(Rcpp::IntegerVector d, Rcpp::IntegerVector s);
+RcppExport SEXP _sshicm_RcppINSSHTable(SEXP dSEXP, SEXP sSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type s(sSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHTable(d, s));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHFromTable
+double RcppINSSHFromTable(Rcpp::IntegerVector d, Rcpp::IntegerVector s, Rcpp::NumericVector count);
+RcppExport SEXP _sshicm_RcppINSSHFromTable(SEXP dSEXP, SEXP sSEXP, SEXP countSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type s(sSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type count(countSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHFromTable(d, s, count));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHStream
+double RcppICSSHStream(Rcpp::Function chunk, int chunk_number, std::string bin_method);
+RcppExport SEXP _sshicm_RcppICSSHStream(SEXP chunkSEXP, SEXP chunk_numberSEXP, SEXP bin_methodSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::Function >::type chunk(chunkSEXP);
+    Rcpp::traits::input_parameter< int >::type chunk_number(chunk_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHStream(chunk, chunk_number, bin_method));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHBreaks
+Rcpp::List RcppINSSHBreaks(Rcpp::IntegerVector d, Rcpp::NumericVector x, int strata_number, int max_candidates, int min_size, int threads);
+RcppExport SEXP _sshicm_RcppINSSHBreaks(SEXP dSEXP, SEXP xSEXP, SEXP strata_numberSEXP, SEXP max_candidatesSEXP, SEXP min_sizeSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type strata_number(strata_numberSEXP);
+    Rcpp::traits::input_parameter< int >::type max_candidates(max_candidatesSEXP);
+    Rcpp::traits::input_parameter< int >::type min_size(min_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHBreaks(d, x, strata_number, max_candidates, min_size, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHBreaks
+Rcpp::List RcppICSSHBreaks(Rcpp::NumericVector d, Rcpp::NumericVector x, int strata_number, std::string bin_method, int max_candidates, int min_size, int threads);
+RcppExport SEXP _sshicm_RcppICSSHBreaks(SEXP dSEXP, SEXP xSEXP, SEXP strata_numberSEXP, SEXP bin_methodSEXP, SEXP max_candidatesSEXP, SEXP min_sizeSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type strata_number(strata_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< int >::type max_candidates(max_candidatesSEXP);
+    Rcpp::traits::input_parameter< int >::type min_size(min_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHBreaks(d, x, strata_number, bin_method, max_candidates, min_size, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHICMInteraction
+Rcpp::List RcppINSSHICMInteraction(Rcpp::IntegerVector d, Rcpp::List s, unsigned int seed, int permutation_number, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, std::string pvalue, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppINSSHICMInteraction(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP pvalueSEXP, SEXP tailSEXP, SEXP planSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type pvalue(pvalueSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHICMInteraction(d, s, seed, permutation_number, sequential, exceed_threshold, alpha, threads, batch_size, pvalue, tail, plan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHICMInteraction
+Rcpp::List RcppICSSHICMInteraction(Rcpp::NumericVector d, Rcpp::List s, unsigned int seed, int permutation_number, std::string bin_method, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool tail, SEXP plan);
+RcppExport SEXP _sshicm_RcppICSSHICMInteraction(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP tailSEXP, SEXP planSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type plan(planSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHICMInteraction(d, s, seed, permutation_number, bin_method, sequential, exceed_threshold, alpha, threads, batch_size, tail, plan));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHICMMulti
+Rcpp::NumericMatrix RcppINSSHICMMulti(Rcpp::IntegerMatrix d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool tail);
+RcppExport SEXP _sshicm_RcppINSSHICMMulti(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP tailSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHICMMulti(d, s, seed, permutation_number, sequential, exceed_threshold, alpha, threads, batch_size, tail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHICMMulti
+Rcpp::NumericMatrix RcppICSSHICMMulti(Rcpp::NumericMatrix d, Rcpp::IntegerVector s, unsigned int seed, int permutation_number, std::string bin_method, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool tail);
+RcppExport SEXP _sshicm_RcppICSSHICMMulti(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP tailSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHICMMulti(d, s, seed, permutation_number, bin_method, sequential, exceed_threshold, alpha, threads, batch_size, tail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppPermutationPlan
+SEXP RcppPermutationPlan(int n, unsigned int seed, int permutation_number, int threads);
+RcppExport SEXP _sshicm_RcppPermutationPlan(SEXP nSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppPermutationPlan(n, seed, permutation_number, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHICMJob
+SEXP RcppICSSHICMJob(Rcpp::NumericVector d, Rcpp::List s, unsigned int seed, int permutation_number, std::string bin_method, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, bool tail);
+RcppExport SEXP _sshicm_RcppICSSHICMJob(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP bin_methodSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP tailSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHICMJob(d, s, seed, permutation_number, bin_method, sequential, exceed_threshold, alpha, threads, batch_size, tail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHICMJob
+SEXP RcppINSSHICMJob(Rcpp::IntegerVector d, Rcpp::List s, unsigned int seed, int permutation_number, bool sequential, int exceed_threshold, double alpha, int threads, int batch_size, std::string pvalue, bool tail);
+RcppExport SEXP _sshicm_RcppINSSHICMJob(SEXP dSEXP, SEXP sSEXP, SEXP seedSEXP, SEXP permutation_numberSEXP, SEXP sequentialSEXP, SEXP exceed_thresholdSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP, SEXP pvalueSEXP, SEXP tailSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type permutation_number(permutation_numberSEXP);
+    Rcpp::traits::input_parameter< bool >::type sequential(sequentialSEXP);
+    Rcpp::traits::input_parameter< int >::type exceed_threshold(exceed_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type pvalue(pvalueSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHICMJob(d, s, seed, permutation_number, sequential, exceed_threshold, alpha, threads, batch_size, pvalue, tail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppJobStatus
+Rcpp::List RcppJobStatus(SEXP job);
+RcppExport SEXP _sshicm_RcppJobStatus(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppJobStatus(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppJobResults
+Rcpp::NumericMatrix RcppJobResults(SEXP job, bool tail);
+RcppExport SEXP _sshicm_RcppJobResults(SEXP jobSEXP, SEXP tailSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    Rcpp::traits::input_parameter< bool >::type tail(tailSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppJobResults(job, tail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppJobCancel
+Rcpp::List RcppJobCancel(SEXP job);
+RcppExport SEXP _sshicm_RcppJobCancel(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppJobCancel(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppINSSHLocal
+Rcpp::NumericMatrix RcppINSSHLocal(Rcpp::IntegerVector d, Rcpp::List s, Rcpp::NumericVector x, Rcpp::NumericVector y, int neighbours, double radius, int threads, int batch_size);
+RcppExport SEXP _sshicm_RcppINSSHLocal(SEXP dSEXP, SEXP sSEXP, SEXP xSEXP, SEXP ySEXP, SEXP neighboursSEXP, SEXP radiusSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type neighbours(neighboursSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppINSSHLocal(d, s, x, y, neighbours, radius, threads, batch_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// RcppICSSHLocal
+Rcpp::NumericMatrix RcppICSSHLocal(Rcpp::NumericVector d, Rcpp::List s, Rcpp::NumericVector x, Rcpp::NumericVector y, int neighbours, double radius, std::string bin_method, int threads, int batch_size);
+RcppExport SEXP _sshicm_RcppICSSHLocal(SEXP dSEXP, SEXP sSEXP, SEXP xSEXP, SEXP ySEXP, SEXP neighboursSEXP, SEXP radiusSEXP, SEXP bin_methodSEXP, SEXP threadsSEXP, SEXP batch_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type d(dSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type s(sSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type neighbours(neighboursSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< std::string >::type bin_method(bin_methodSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(RcppICSSHLocal(d, s, x, y, neighbours, radius, bin_method, threads, batch_size));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
     {"_sshicm_RcppINSSH", (DL_FUNC) &_sshicm_RcppINSSH, 2},
-    {"_sshicm_RcppINSSHICM", (DL_FUNC) &_sshicm_RcppINSSHICM, 4},
+    {"_sshicm_RcppINSSHICM", (DL_FUNC) &_sshicm_RcppINSSHICM, 13},
     {"_sshicm_RcppICSSH", (DL_FUNC) &_sshicm_RcppICSSH, 3},
-    {"_sshicm_RcppICSSHICM", (DL_FUNC) &_sshicm_RcppICSSHICM, 5},
+    {"_sshicm_RcppICSSHICM", (DL_FUNC) &_sshicm_RcppICSSHICM, 13},
+    {"_sshicm_RcppINSSHICMBatch", (DL_FUNC) &_sshicm_RcppINSSHICMBatch, 13},
+    {"_sshicm_RcppICSSHICMBatch", (DL_FUNC) &_sshicm_RcppICSSHICMBatch, 13},
+    {"_sshicm_RcppINSSHTable", (DL_FUNC) &_sshicm_RcppINSSHTable, 2},
+    {"_sshicm_RcppINSSHFromTable", (DL_FUNC) &_sshicm_RcppINSSHFromTable, 3},
+    {"_sshicm_RcppICSSHStream", (DL_FUNC) &_sshicm_RcppICSSHStream, 3},
+    {"_sshicm_RcppINSSHBreaks", (DL_FUNC) &_sshicm_RcppINSSHBreaks, 6},
+    {"_sshicm_RcppICSSHBreaks", (DL_FUNC) &_sshicm_RcppICSSHBreaks, 7},
+    {"_sshicm_RcppINSSHICMInteraction", (DL_FUNC) &_sshicm_RcppINSSHICMInteraction, 12},
+    {"_sshicm_RcppICSSHICMInteraction", (DL_FUNC) &_sshicm_RcppICSSHICMInteraction, 12},
+    {"_sshicm_RcppINSSHICMMulti", (DL_FUNC) &_sshicm_RcppINSSHICMMulti, 10},
+    {"_sshicm_RcppICSSHICMMulti", (DL_FUNC) &_sshicm_RcppICSSHICMMulti, 11},
+    {"_sshicm_RcppPermutationPlan", (DL_FUNC) &_sshicm_RcppPermutationPlan, 4},
+    {"_sshicm_RcppICSSHICMJob", (DL_FUNC) &_sshicm_RcppICSSHICMJob, 11},
+    {"_sshicm_RcppINSSHICMJob", (DL_FUNC) &_sshicm_RcppINSSHICMJob, 11},
+    {"_sshicm_RcppJobStatus", (DL_FUNC) &_sshicm_RcppJobStatus, 1},
+    {"_sshicm_RcppJobResults", (DL_FUNC) &_sshicm_RcppJobResults, 2},
+    {"_sshicm_RcppJobCancel", (DL_FUNC) &_sshicm_RcppJobCancel, 1},
+    {"_sshicm_RcppINSSHLocal", (DL_FUNC) &_sshicm_RcppINSSHLocal, 8},
+    {"_sshicm_RcppICSSHLocal", (DL_FUNC) &_sshicm_RcppICSSHLocal, 9},
     {NULL, NULL, 0}
 };
 
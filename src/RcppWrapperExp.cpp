@@ -1,17 +1,110 @@
 #include <vector>
-#include "IN_SSH.h"
-#include "IC_SSH.h"
+#include <sshicm/sshicm.h>
 #include <Rcpp.h>
 
+// [[Rcpp::plugins(cpp11)]]
+// [[Rcpp::depends(RcppThread)]]
+
+// Thin Rcpp wrappers over the header-only core in inst/include/sshicm, which is built with its
+// RcppThread backend (SSHICM_USE_RCPPTHREAD, see Makevars)
+using sshicm::Span;
+using sshicm::ProfileReport;
+using sshicm::kProfilePhaseNumber;
+using sshicm::ProfilePhaseName;
+
+// The wrappers hand the core spans over the storage of the R vectors instead of copies; the core
+// only reads them (also from RcppThread workers) and never calls back into R
+
+// Span over each element of an R list of integer vectors; the elements are kept in s_vectors,
+// which coerces them to integer only where needed
+static std::vector<Span<int>> ListSpans(const Rcpp::List& s, std::vector<Rcpp::IntegerVector>& s_vectors) {
+  s_vectors.reserve(s.size());
+  std::vector<Span<int>> s_spans;
+  s_spans.reserve(s.size());
+  for (int i = 0; i < s.size(); ++i) {
+    s_vectors.push_back(Rcpp::as<Rcpp::IntegerVector>(s[i]));
+    s_spans.push_back(Span<int>(s_vectors.back().begin(), s_vectors.back().size()));
+  }
+  return s_spans;
+}
+
+// Permutation plan held by an external pointer from RcppPermutationPlan, or none for NULL and for
+// a pointer that did not survive saving the R session, in which case the permutations are shuffled
+// again with identical results
+static const sshicm::PermutationPlan* PlanPointer(SEXP plan) {
+  if (Rf_isNull(plan)) {
+    return nullptr;
+  }
+  return Rcpp::XPtr<sshicm::PermutationPlan>(plan).get();
+}
+
+// Convert the results of a batch into a matrix with one row per stratification: value, p-value,
+// permutations used, and with the tail p-value the tail p-value and its goodness of fit
+static Rcpp::NumericMatrix ResultsToMatrix(const std::vector<std::vector<double>>& result) {
+  size_t column_number = result.empty() ? 3 : result[0].size();
+  Rcpp::NumericMatrix result_matrix(result.size(), column_number);
+  for (size_t i = 0; i < result.size(); ++i) {
+    for (size_t j = 0; j < column_number; ++j) {
+      result_matrix(i, j) = result[i][j];
+    }
+  }
+  return result_matrix;
+}
+
+// Convert a profile report into a list of data frames (phases, threads, strata) and a named
+// counters vector, attached to the results as the "profile" attribute
+static Rcpp::List ProfileToList(const ProfileReport& report) {
+  std::vector<std::string> phase_names;
+  for (int phase = 0; phase < kProfilePhaseNumber; ++phase) {
+    phase_names.push_back(ProfilePhaseName(phase));
+  }
+  Rcpp::DataFrame phases = Rcpp::DataFrame::create(
+    Rcpp::Named("phase") = phase_names,
+    Rcpp::Named("seconds") = report.phase_seconds,
+    Rcpp::Named("stringsAsFactors") = false);
+
+  Rcpp::NumericVector counters = Rcpp::NumericVector::create(
+    Rcpp::Named("wall_seconds") = report.wall_seconds,
+    Rcpp::Named("permutations") = report.permutations,
+    Rcpp::Named("evaluations") = report.evaluations,
+    Rcpp::Named("bytes_allocated") = report.bytes_allocated);
+
+  std::vector<int> thread_ids;
+  for (size_t t = 0; t < report.thread_busy_seconds.size(); ++t) {
+    thread_ids.push_back(static_cast<int>(t) + 1);
+  }
+  Rcpp::DataFrame threads = Rcpp::DataFrame::create(
+    Rcpp::Named("thread") = thread_ids,
+    Rcpp::Named("busy_seconds") = report.thread_busy_seconds);
+
+  std::vector<int> variables, strata;
+  std::vector<double> seconds, evaluations;
+  for (size_t v = 0; v < report.stratum_seconds.size(); ++v) {
+    for (size_t k = 0; k < report.stratum_seconds[v].size(); ++k) {
+      variables.push_back(static_cast<int>(v) + 1);
+      strata.push_back(static_cast<int>(k) + 1);
+      seconds.push_back(report.stratum_seconds[v][k]);
+      evaluations.push_back(report.stratum_evaluations[v][k]);
+    }
+  }
+  Rcpp::DataFrame stratum_costs = Rcpp::DataFrame::create(
+    Rcpp::Named("variable") = variables,
+    Rcpp::Named("stratum") = strata,
+    Rcpp::Named("seconds") = seconds,
+    Rcpp::Named("evaluations") = evaluations);
+
+  return Rcpp::List::create(
+    Rcpp::Named("phases") = phases,
+    Rcpp::Named("counters") = counters,
+    Rcpp::Named("threads") = threads,
+    Rcpp::Named("strata") = stratum_costs);
+}
+
 // Rcpp wrapper for IN_SSH
 // [[Rcpp::export]]
 double RcppINSSH(Rcpp::IntegerVector d, Rcpp::IntegerVector s) {
-  // Convert Rcpp::IntegerVector to std::vector<int>
-  std::vector<int> d_std = Rcpp::as<std::vector<int>>(d);
-  std::vector<int> s_std = Rcpp::as<std::vector<int>>(s);
-
-  // Call the IN_SSH function
-  double result = IN_SSH(d_std, s_std);
+  // Call the IN_SSH function on the R vectors in place
+  double result = sshicm::IN_SSH(Span<int>(d.begin(), d.size()), Span<int>(s.begin(), s.size()));
 
   // Return the result as a double
   return result;
@@ -22,13 +115,33 @@ double RcppINSSH(Rcpp::IntegerVector d, Rcpp::IntegerVector s) {
 Rcpp::NumericVector RcppINSSHICM(Rcpp::IntegerVector d,
                                  Rcpp::IntegerVector s,
                                  unsigned int seed,
-                                 int permutation_number) {
-  // Convert Rcpp::IntegerVector to std::vector<int>
-  std::vector<int> d_std = Rcpp::as<std::vector<int>>(d);
-  std::vector<int> s_std = Rcpp::as<std::vector<int>>(s);
-
-  // Call the IN_SSHICM function
-  std::vector<double> result = IN_SSHICM(d_std, s_std, seed, permutation_number);
+                                 int permutation_number,
+                                 bool sequential = false,
+                                 int exceed_threshold = 10,
+                                 double alpha = 0.05,
+                                 int threads = 0,
+                                 int batch_size = 0,
+                                 bool profile = false,
+                                 std::string pvalue = "permutation",
+                                 bool tail = false,
+                                 SEXP plan = R_NilValue) {
+  // Call the IN_SSHICM function on the R vectors in place, through the profiled batch when asked
+  Span<int> d_span(d.begin(), d.size());
+  Span<int> s_span(s.begin(), s.size());
+  sshicm::PValueMethod pvalue_method = sshicm::ParsePValueMethod(pvalue);
+  if (profile) {
+    ProfileReport report;
+    std::vector<double> result = sshicm::IN_SSHICM_BatchProfiled(d_span, std::vector<Span<int>>(1, s_span), seed,
+                                                                 permutation_number, sequential, exceed_threshold,
+                                                                 alpha, threads, batch_size, pvalue_method, tail,
+                                                                 PlanPointer(plan), report)[0];
+    Rcpp::NumericVector result_vector = Rcpp::wrap(result);
+    result_vector.attr("profile") = ProfileToList(report);
+    return result_vector;
+  }
+  std::vector<double> result = sshicm::IN_SSHICM(d_span, s_span, seed, permutation_number,
+                                                 sequential, exceed_threshold, alpha, threads, batch_size,
+                                                 pvalue_method, tail, PlanPointer(plan));
 
   // Convert the std::vector<double> result to Rcpp::NumericVector
   return Rcpp::wrap(result);
@@ -39,14 +152,8 @@ Rcpp::NumericVector RcppINSSHICM(Rcpp::IntegerVector d,
 double RcppICSSH(Rcpp::NumericVector d,
                  Rcpp::IntegerVector s,
                  std::string bin_method = "Sturges") {
-  // Convert Rcpp::NumericVector to std::vector<double>
-  std::vector<double> d_std = Rcpp::as<std::vector<double>>(d);
-
-  // Convert Rcpp::IntegerVector to std::vector<int>
-  std::vector<int> s_std = Rcpp::as<std::vector<int>>(s);
-
-  // Call the IC_SSH function
-  double result = IC_SSH(d_std, s_std, bin_method);
+  // Call the IC_SSH function on the R vectors in place
+  double result = sshicm::IC_SSH(Span<double>(d.begin(), d.size()), Span<int>(s.begin(), s.size()), bin_method);
 
   // Return the result as a double
   return result;
@@ -58,16 +165,483 @@ Rcpp::NumericVector RcppICSSHICM(Rcpp::NumericVector d,
                                  Rcpp::IntegerVector s,
                                  unsigned int seed,
                                  int permutation_number,
-                                 std::string bin_method = "Sturges") {
-  // Convert Rcpp::NumericVector to std::vector<double>
-  std::vector<double> d_std = Rcpp::as<std::vector<double>>(d);
-
-  // Convert Rcpp::IntegerVector to std::vector<int>
-  std::vector<int> s_std = Rcpp::as<std::vector<int>>(s);
-
-  // Call the IC_SSHICM function
-  std::vector<double> result = IC_SSHICM(d_std, s_std, seed, permutation_number, bin_method);
+                                 std::string bin_method = "Sturges",
+                                 bool sequential = false,
+                                 int exceed_threshold = 10,
+                                 double alpha = 0.05,
+                                 int threads = 0,
+                                 int batch_size = 0,
+                                 bool profile = false,
+                                 bool tail = false,
+                                 SEXP plan = R_NilValue) {
+  // Call the IC_SSHICM function on the R vectors in place, through the profiled batch when asked
+  Span<double> d_span(d.begin(), d.size());
+  Span<int> s_span(s.begin(), s.size());
+  if (profile) {
+    ProfileReport report;
+    std::vector<double> result = sshicm::IC_SSHICM_BatchProfiled(d_span, std::vector<Span<int>>(1, s_span), seed,
+                                                                 permutation_number, bin_method, sequential,
+                                                                 exceed_threshold, alpha, threads, batch_size, tail,
+                                                                 PlanPointer(plan), report)[0];
+    Rcpp::NumericVector result_vector = Rcpp::wrap(result);
+    result_vector.attr("profile") = ProfileToList(report);
+    return result_vector;
+  }
+  std::vector<double> result = sshicm::IC_SSHICM(d_span, s_span, seed, permutation_number, bin_method,
+                                                 sequential, exceed_threshold, alpha, threads, batch_size, tail,
+                                                 PlanPointer(plan));
 
   // Convert the std::vector<double> result to Rcpp::NumericVector
   return Rcpp::wrap(result);
 }
+
+// Rcpp wrapper for IN_SSHICM_Batch
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppINSSHICMBatch(Rcpp::IntegerVector d,
+                                      Rcpp::List s,
+                                      unsigned int seed,
+                                      int permutation_number,
+                                      bool sequential = false,
+                                      int exceed_threshold = 10,
+                                      double alpha = 0.05,
+                                      int threads = 0,
+                                      int batch_size = 0,
+                                      bool profile = false,
+                                      std::string pvalue = "permutation",
+                                      bool tail = false,
+                                      SEXP plan = R_NilValue) {
+  // View d and each element of Rcpp::List in place
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+
+  // Call the IN_SSHICM_Batch function, through the profiled batch when asked
+  sshicm::PValueMethod pvalue_method = sshicm::ParsePValueMethod(pvalue);
+  ProfileReport report;
+  std::vector<std::vector<double>> result = profile ?
+    sshicm::IN_SSHICM_BatchProfiled(Span<int>(d.begin(), d.size()), s_spans, seed, permutation_number,
+                                    sequential, exceed_threshold, alpha, threads, batch_size, pvalue_method,
+                                    tail, PlanPointer(plan), report) :
+    sshicm::IN_SSHICM_Batch(Span<int>(d.begin(), d.size()), s_spans, seed, permutation_number,
+                            sequential, exceed_threshold, alpha, threads, batch_size, pvalue_method, tail,
+                            PlanPointer(plan));
+
+  // Convert the result to a matrix with one row per stratification
+  Rcpp::NumericMatrix result_matrix = ResultsToMatrix(result);
+  if (profile) {
+    result_matrix.attr("profile") = ProfileToList(report);
+  }
+  return result_matrix;
+}
+
+// Rcpp wrapper for IC_SSHICM_Batch
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppICSSHICMBatch(Rcpp::NumericVector d,
+                                      Rcpp::List s,
+                                      unsigned int seed,
+                                      int permutation_number,
+                                      std::string bin_method = "Sturges",
+                                      bool sequential = false,
+                                      int exceed_threshold = 10,
+                                      double alpha = 0.05,
+                                      int threads = 0,
+                                      int batch_size = 0,
+                                      bool profile = false,
+                                      bool tail = false,
+                                      SEXP plan = R_NilValue) {
+  // View d and each element of Rcpp::List in place
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+
+  // Call the IC_SSHICM_Batch function, through the profiled batch when asked
+  ProfileReport report;
+  std::vector<std::vector<double>> result = profile ?
+    sshicm::IC_SSHICM_BatchProfiled(Span<double>(d.begin(), d.size()), s_spans, seed, permutation_number, bin_method,
+                                    sequential, exceed_threshold, alpha, threads, batch_size, tail, PlanPointer(plan),
+                                    report) :
+    sshicm::IC_SSHICM_Batch(Span<double>(d.begin(), d.size()), s_spans, seed, permutation_number, bin_method,
+                            sequential, exceed_threshold, alpha, threads, batch_size, tail, PlanPointer(plan));
+
+  // Convert the result to a matrix with one row per stratification
+  Rcpp::NumericMatrix result_matrix = ResultsToMatrix(result);
+  if (profile) {
+    result_matrix.attr("profile") = ProfileToList(report);
+  }
+  return result_matrix;
+}
+
+// Rcpp wrapper for ContingencyTable: the non-zero joint counts of s and d, one row per cell with
+// columns s, d and count
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppINSSHTable(Rcpp::IntegerVector d, Rcpp::IntegerVector s) {
+  // Count the R vectors in place
+  sshicm::ContingencyTable table;
+  table.Add(Span<int>(d.begin(), d.size()), Span<int>(s.begin(), s.size()));
+
+  // Convert the cells to a matrix
+  Rcpp::NumericMatrix result_matrix(table.cell_number(), 3);
+  int i = 0;
+  for (const auto& cell : table.joint_frequency()) {
+    result_matrix(i, 0) = cell.first.first;
+    result_matrix(i, 1) = cell.first.second;
+    result_matrix(i, 2) = static_cast<double>(cell.second);
+    ++i;
+  }
+  return result_matrix;
+}
+
+// Rcpp wrapper for IN_SSH_Table: IN_SSH of the cells (d, s) holding `count` rows each
+// [[Rcpp::export]]
+double RcppINSSHFromTable(Rcpp::IntegerVector d, Rcpp::IntegerVector s, Rcpp::NumericVector count) {
+  if (d.size() != s.size() || d.size() != count.size()) {
+    throw std::invalid_argument("Vectors d, s and count must have the same length.");
+  }
+
+  // Step 1: Rebuild the contingency table from its cells
+  sshicm::ContingencyTable table;
+  for (int i = 0; i < d.size(); ++i) {
+    table.AddCount(d[i], s[i], static_cast<int64_t>(count[i]));
+  }
+
+  // Step 2: Compute IN_SSH from the table
+  return sshicm::IN_SSH_Table(table);
+}
+
+// Rcpp wrapper for streaming IC_SSH: chunk(i) returns list(d, s) for the chunks i = 1, ...,
+// chunk_number and is called once per chunk in each of the three passes
+// [[Rcpp::export]]
+double RcppICSSHStream(Rcpp::Function chunk, int chunk_number, std::string bin_method) {
+  auto read_chunk = [&](int i, Rcpp::NumericVector& d, Rcpp::IntegerVector& s) {
+    Rcpp::List x = chunk(i + 1);
+    d = x[0];
+    s = x[1];
+  };
+  Rcpp::NumericVector d;
+  Rcpp::IntegerVector s;
+
+  // Step 1: Ranges of the strata
+  sshicm::ICStreamRanges ranges;
+  for (int i = 0; i < chunk_number; ++i) {
+    read_chunk(i, d, s);
+    ranges.Add(Span<double>(d.begin(), d.size()), Span<int>(s.begin(), s.size()));
+  }
+
+  // Step 2: Counts of d in the ranges, which fix the bins
+  sshicm::ICStreamCounts counts(ranges, bin_method);
+  for (int i = 0; i < chunk_number; ++i) {
+    read_chunk(i, d, s);
+    counts.Add(Span<double>(d.begin(), d.size()));
+  }
+
+  // Step 3: Histograms on those bins
+  sshicm::ICStreamHistograms histograms(ranges, counts);
+  for (int i = 0; i < chunk_number; ++i) {
+    read_chunk(i, d, s);
+    histograms.Add(Span<double>(d.begin(), d.size()), Span<int>(s.begin(), s.size()));
+  }
+
+  return sshicm::IC_SSH_Stream(histograms);
+}
+
+// Convert the breakpoints found by a search into a list of the breaks, the measure of the scheme
+// and the stratum of every row
+static Rcpp::List BreakpointsToList(const sshicm::BreakpointResult& result) {
+  return Rcpp::List::create(
+    Rcpp::Named("breaks") = result.breaks,
+    Rcpp::Named("value") = result.value,
+    Rcpp::Named("strata") = result.strata);
+}
+
+// Rcpp wrapper for IN_SSH_Breakpoints
+// [[Rcpp::export]]
+Rcpp::List RcppINSSHBreaks(Rcpp::IntegerVector d,
+                           Rcpp::NumericVector x,
+                           int strata_number,
+                           int max_candidates = 100,
+                           int min_size = 1,
+                           int threads = 0) {
+  return BreakpointsToList(sshicm::IN_SSH_Breakpoints(Span<int>(d.begin(), d.size()),
+                                                      Span<double>(x.begin(), x.size()),
+                                                      strata_number, max_candidates, min_size, threads));
+}
+
+// Rcpp wrapper for IC_SSH_Breakpoints
+// [[Rcpp::export]]
+Rcpp::List RcppICSSHBreaks(Rcpp::NumericVector d,
+                           Rcpp::NumericVector x,
+                           int strata_number,
+                           std::string bin_method = "Sturges",
+                           int max_candidates = 100,
+                           int min_size = 2,
+                           int threads = 0) {
+  return BreakpointsToList(sshicm::IC_SSH_Breakpoints(Span<double>(d.begin(), d.size()),
+                                                      Span<double>(x.begin(), x.size()),
+                                                      strata_number, bin_method, max_candidates, min_size,
+                                                      threads));
+}
+
+// Convert a p x p interaction matrix of results into a list of the value, p-value and
+// permutations-used matrices, and with tail p-values of the tail p-value and goodness-of-fit ones
+static Rcpp::List InteractionToList(const std::vector<std::vector<double>>& matrix, size_t variable_number) {
+  size_t column_number = matrix.empty() ? 3 : matrix[0].size();
+  std::vector<Rcpp::NumericMatrix> columns;
+  for (size_t c = 0; c < column_number; ++c) {
+    columns.push_back(Rcpp::NumericMatrix(variable_number, variable_number));
+  }
+  for (size_t i = 0; i < variable_number; ++i) {
+    for (size_t j = 0; j < variable_number; ++j) {
+      const std::vector<double>& cell = matrix[i * variable_number + j];
+      for (size_t c = 0; c < column_number; ++c) {
+        columns[c](i, j) = cell[c];
+      }
+    }
+  }
+  Rcpp::List result = Rcpp::List::create(
+    Rcpp::Named("value") = columns[0],
+    Rcpp::Named("pvalue") = columns[1],
+    Rcpp::Named("permutations") = columns[2]);
+  if (column_number == 5) {
+    result["tail_pvalue"] = columns[3];
+    result["gof"] = columns[4];
+  }
+  return result;
+}
+
+// Rcpp wrapper for IN_SSHICM_Interaction
+// [[Rcpp::export]]
+Rcpp::List RcppINSSHICMInteraction(Rcpp::IntegerVector d,
+                                   Rcpp::List s,
+                                   unsigned int seed,
+                                   int permutation_number,
+                                   bool sequential = false,
+                                   int exceed_threshold = 10,
+                                   double alpha = 0.05,
+                                   int threads = 0,
+                                   int batch_size = 0,
+                                   std::string pvalue = "permutation",
+                                   bool tail = false,
+                                   SEXP plan = R_NilValue) {
+  // View d and each element of Rcpp::List in place
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+
+  return InteractionToList(
+    sshicm::IN_SSHICM_Interaction(Span<int>(d.begin(), d.size()), s_spans, seed, permutation_number, sequential,
+                                  exceed_threshold, alpha, threads, batch_size, sshicm::ParsePValueMethod(pvalue),
+                                  tail, PlanPointer(plan)),
+    s_spans.size());
+}
+
+// Rcpp wrapper for IC_SSHICM_Interaction
+// [[Rcpp::export]]
+Rcpp::List RcppICSSHICMInteraction(Rcpp::NumericVector d,
+                                   Rcpp::List s,
+                                   unsigned int seed,
+                                   int permutation_number,
+                                   std::string bin_method = "Sturges",
+                                   bool sequential = false,
+                                   int exceed_threshold = 10,
+                                   double alpha = 0.05,
+                                   int threads = 0,
+                                   int batch_size = 0,
+                                   bool tail = false,
+                                   SEXP plan = R_NilValue) {
+  // View d and each element of Rcpp::List in place
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+
+  return InteractionToList(
+    sshicm::IC_SSHICM_Interaction(Span<double>(d.begin(), d.size()), s_spans, seed, permutation_number, bin_method,
+                                  sequential, exceed_threshold, alpha, threads, batch_size, tail,
+                                  PlanPointer(plan)),
+    s_spans.size());
+}
+
+// Rcpp wrapper for IN_SSHICM_MultiResponse: one row per column of d
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppINSSHICMMulti(Rcpp::IntegerMatrix d,
+                                      Rcpp::IntegerVector s,
+                                      unsigned int seed,
+                                      int permutation_number,
+                                      bool sequential = false,
+                                      int exceed_threshold = 10,
+                                      double alpha = 0.05,
+                                      int threads = 0,
+                                      int batch_size = 0,
+                                      bool tail = false) {
+  // View the column-major matrix and s in place
+  return ResultsToMatrix(
+    sshicm::IN_SSHICM_MultiResponse(Span<int>(d.begin(), d.size()), d.ncol(), Span<int>(s.begin(), s.size()),
+                                    seed, permutation_number, sequential, exceed_threshold, alpha, threads,
+                                    batch_size, tail));
+}
+
+// Rcpp wrapper for IC_SSHICM_MultiResponse: one row per column of d
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppICSSHICMMulti(Rcpp::NumericMatrix d,
+                                      Rcpp::IntegerVector s,
+                                      unsigned int seed,
+                                      int permutation_number,
+                                      std::string bin_method = "Sturges",
+                                      bool sequential = false,
+                                      int exceed_threshold = 10,
+                                      double alpha = 0.05,
+                                      int threads = 0,
+                                      int batch_size = 0,
+                                      bool tail = false) {
+  // View the column-major matrix and s in place
+  return ResultsToMatrix(
+    sshicm::IC_SSHICM_MultiResponse(Span<double>(d.begin(), d.size()), d.ncol(), Span<int>(s.begin(), s.size()),
+                                    seed, permutation_number, bin_method, sequential, exceed_threshold, alpha,
+                                    threads, batch_size, tail));
+}
+
+// Permutation plan of n rows for a seed, kept by R as an external pointer and handed to the
+// permutation tests through their `plan` argument
+// [[Rcpp::export]]
+SEXP RcppPermutationPlan(int n, unsigned int seed, int permutation_number, int threads = 0) {
+  return Rcpp::XPtr<sshicm::PermutationPlan>(new sshicm::PermutationPlan(n, seed, permutation_number, threads), true);
+}
+
+// Copy each element of an R list of integer vectors, for the jobs that outlive the call
+static std::vector<std::vector<int>> ListVectors(const Rcpp::List& s) {
+  std::vector<std::vector<int>> s_list;
+  s_list.reserve(s.size());
+  for (int i = 0; i < s.size(); ++i) {
+    s_list.push_back(Rcpp::as<std::vector<int>>(s[i]));
+  }
+  return s_list;
+}
+
+// External pointer holding a job. Its finalizer cancels the job and waits for it, and also runs
+// when R exits, so that no job thread outlives the session
+typedef Rcpp::XPtr<sshicm::SSHICMJob, Rcpp::PreserveStorage,
+                   &Rcpp::standard_delete_finalizer<sshicm::SSHICMJob>, true> JobXPtr;
+
+// Job held by an external pointer from RcppICSSHICMJob / RcppINSSHICMJob
+static sshicm::SSHICMJob* JobPointer(SEXP job) {
+  sshicm::SSHICMJob* pointer = JobXPtr(job).get();
+  if (!pointer) {
+    Rcpp::stop("The job is no longer available.");
+  }
+  return pointer;
+}
+
+// Start IC_SSHICM_Batch as a background job (see Job.h), returned as an external pointer
+// [[Rcpp::export]]
+SEXP RcppICSSHICMJob(Rcpp::NumericVector d,
+                     Rcpp::List s,
+                     unsigned int seed,
+                     int permutation_number,
+                     std::string bin_method = "Sturges",
+                     bool sequential = false,
+                     int exceed_threshold = 10,
+                     double alpha = 0.05,
+                     int threads = 0,
+                     int batch_size = 0,
+                     bool tail = false) {
+  std::unique_ptr<sshicm::SSHICMJob> job =
+    sshicm::StartIC_SSHICM_Job(Rcpp::as<std::vector<double>>(d), ListVectors(s), seed, permutation_number,
+                               bin_method, sequential, exceed_threshold, alpha, threads, batch_size, tail);
+  return JobXPtr(job.release(), true);
+}
+
+// Start IN_SSHICM_Batch as a background job (see Job.h), returned as an external pointer
+// [[Rcpp::export]]
+SEXP RcppINSSHICMJob(Rcpp::IntegerVector d,
+                     Rcpp::List s,
+                     unsigned int seed,
+                     int permutation_number,
+                     bool sequential = false,
+                     int exceed_threshold = 10,
+                     double alpha = 0.05,
+                     int threads = 0,
+                     int batch_size = 0,
+                     std::string pvalue = "permutation",
+                     bool tail = false) {
+  std::unique_ptr<sshicm::SSHICMJob> job =
+    sshicm::StartIN_SSHICM_Job(Rcpp::as<std::vector<int>>(d), ListVectors(s), seed, permutation_number,
+                               sequential, exceed_threshold, alpha, threads, batch_size,
+                               sshicm::ParsePValueMethod(pvalue), tail);
+  return JobXPtr(job.release(), true);
+}
+
+// Progress of a job: its state, the variables and permutations done and their totals, and the
+// error message of a failed job
+// [[Rcpp::export]]
+Rcpp::List RcppJobStatus(SEXP job) {
+  sshicm::JobStatus status = JobPointer(job)->Status();
+  return Rcpp::List::create(Rcpp::Named("state") = sshicm::JobStateName(status.state),
+                            Rcpp::Named("variables_done") = static_cast<double>(status.variables_done),
+                            Rcpp::Named("variable_number") = static_cast<double>(status.variable_number),
+                            Rcpp::Named("permutations_done") = status.permutations_done,
+                            Rcpp::Named("permutations_total") = status.permutations_total,
+                            Rcpp::Named("error") = status.error);
+}
+
+// Results of a job so far, as the batch wrappers return them, with NA rows for the variables not
+// done yet
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppJobResults(SEXP job, bool tail = false) {
+  std::vector<std::vector<double>> result = JobPointer(job)->Results();
+  std::vector<double> pending(tail ? 5 : 3, NA_REAL);
+  for (std::vector<double>& row : result) {
+    if (row.empty()) {
+      row = pending;
+    }
+  }
+  return ResultsToMatrix(result);
+}
+
+// Cancel a job at its next checkpoint, and return its progress
+// [[Rcpp::export]]
+Rcpp::List RcppJobCancel(SEXP job) {
+  JobPointer(job)->Cancel();
+  return RcppJobStatus(job);
+}
+
+// Convert the results of a local statistic (result[v][location]) into a matrix with one row per
+// location and one column per stratification
+static Rcpp::NumericMatrix LocalToMatrix(const std::vector<std::vector<double>>& result, size_t location_number) {
+  Rcpp::NumericMatrix result_matrix(location_number, result.size());
+  for (size_t v = 0; v < result.size(); ++v) {
+    std::copy(result[v].begin(), result[v].end(), result_matrix.begin() + v * location_number);
+  }
+  return result_matrix;
+}
+
+// Rcpp wrapper for IN_SSH_Local
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppINSSHLocal(Rcpp::IntegerVector d,
+                                   Rcpp::List s,
+                                   Rcpp::NumericVector x,
+                                   Rcpp::NumericVector y,
+                                   int neighbours,
+                                   double radius = 0,
+                                   int threads = 0,
+                                   int batch_size = 0) {
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+  return LocalToMatrix(
+    sshicm::IN_SSH_Local(Span<int>(d.begin(), d.size()), s_spans, Span<double>(x.begin(), x.size()),
+                         Span<double>(y.begin(), y.size()), neighbours, radius, threads, batch_size),
+    d.size());
+}
+
+// Rcpp wrapper for IC_SSH_Local
+// [[Rcpp::export]]
+Rcpp::NumericMatrix RcppICSSHLocal(Rcpp::NumericVector d,
+                                   Rcpp::List s,
+                                   Rcpp::NumericVector x,
+                                   Rcpp::NumericVector y,
+                                   int neighbours,
+                                   double radius = 0,
+                                   std::string bin_method = "Sturges",
+                                   int threads = 0,
+                                   int batch_size = 0) {
+  std::vector<Rcpp::IntegerVector> s_vectors;
+  std::vector<Span<int>> s_spans = ListSpans(s, s_vectors);
+  return LocalToMatrix(
+    sshicm::IC_SSH_Local(Span<double>(d.begin(), d.size()), s_spans, Span<double>(x.begin(), x.size()),
+                         Span<double>(y.begin(), y.size()), neighbours, radius, bin_method, threads, batch_size),
+    d.size());
+}
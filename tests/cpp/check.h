@@ -0,0 +1,55 @@
+// Helpers of the equivalence checks in tests/cpp, built without R by the top-level CMakeLists.txt
+// and run by ctest. Each check compares a fast path of the C++ core with the path whose results it
+// promises to reproduce, and exits with a non-zero status when any comparison fails.
+
+#ifndef SSHICM_CHECK_H
+#define SSHICM_CHECK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Number of failed comparisons of the running check
+inline int& CheckFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+// Record a comparison, printing its name when it fails
+inline void Check(bool passed, const std::string& name) {
+  if (!passed) {
+    std::fprintf(stderr, "FAILED: %s\n", name.c_str());
+    CheckFailures()++;
+  }
+}
+
+// Whether two values are equal within a relative tolerance, NaN matching NaN only
+inline bool SameValue(double a, double b, double tolerance = 0.0) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b);
+  }
+  return a == b || std::fabs(a - b) <= tolerance * std::max(std::fabs(a), std::fabs(b));
+}
+
+// Whether two result rows (e.g. {value, p-value, permutations used, ...}) are identical
+inline bool SameRow(const std::vector<double>& a, const std::vector<double>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (!SameValue(a[i], b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Exit status of the running check, after a summary line
+inline int CheckResult(const char* name) {
+  std::printf("%s: %s\n", name, CheckFailures() == 0 ? "passed" : "FAILED");
+  return CheckFailures() == 0 ? 0 : 1;
+}
+
+#endif // SSHICM_CHECK_H
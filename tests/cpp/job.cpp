@@ -0,0 +1,92 @@
+// Background jobs (Job.h) against the batch they promise to reproduce: a finished IC / IN job must
+// hold the rows of IC_ / IN_SSHICM_Batch on the same arguments, including tail p-values, whatever
+// the number of threads of its own pool and while other jobs run next to it; a cancelled job keeps
+// the rows of the variables it finished, which must also be those of the batch.
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sshicm/sshicm.h>
+#include "check.h"
+
+using namespace sshicm;
+
+// Whether the rows of a job are those of the batch, rows not done (empty) excepted when the job
+// was cancelled
+static bool SameAsBatch(const SSHICMJob& job, const std::vector<std::vector<double>>& batch) {
+  std::vector<std::vector<double>> rows = job.Results();
+  if (rows.size() != batch.size()) {
+    return false;
+  }
+  bool cancelled = job.Status().state == kJobCancelled;
+  for (size_t v = 0; v < rows.size(); ++v) {
+    if (!(cancelled && rows[v].empty()) && !SameRow(rows[v], batch[v])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  const size_t n = 2000;
+  const int permutation_number = 199;
+  const unsigned int seed = 5;
+  std::mt19937 rng(3);
+  std::normal_distribution<double> noise(0.0, 1.0);
+
+  // Step 1: Stratifications and targets that depend on some of them
+  std::vector<std::vector<int>> s(4, std::vector<int>(n));
+  std::vector<double> d_ic(n);
+  std::vector<int> d_in(n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t v = 0; v < s.size(); ++v) {
+      s[v][i] = static_cast<int>(rng() % (v + 3)) + 1;
+    }
+    d_ic[i] = 0.3 * s[1][i] + noise(rng);
+    d_in[i] = rng() % 4 == 0 ? static_cast<int>(rng() % 3) + 1 : s[2][i] % 3 + 1;
+  }
+  std::vector<Span<int>> s_list;
+  for (const std::vector<int>& codes : s) {
+    s_list.push_back(Span<int>(codes));
+  }
+
+  for (bool tail : {false, true}) {
+    std::string options = tail ? " tail" : "";
+    std::vector<std::vector<double>> ic_batch =
+      IC_SSHICM_Batch(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges", false, 10, 0.05, 1, 0, tail);
+    std::vector<std::vector<double>> in_batch =
+      IN_SSHICM_Batch(Span<int>(d_in), s_list, seed, permutation_number, false, 10, 0.05, 1, 0,
+                      kPValuePermutation, tail);
+
+    // Step 2: Jobs with pools of different sizes, running at the same time
+    std::vector<std::unique_ptr<SSHICMJob>> jobs;
+    for (int threads : {1, 2, 3}) {
+      jobs.push_back(StartIC_SSHICM_Job(d_ic, s, seed, permutation_number, "Sturges", false, 10, 0.05, threads, 0,
+                                        tail));
+      jobs.push_back(StartIN_SSHICM_Job(d_in, s, seed, permutation_number, false, 10, 0.05, threads, 0,
+                                        kPValuePermutation, tail));
+    }
+    for (size_t j = 0; j < jobs.size(); ++j) {
+      jobs[j]->Wait();
+      std::string name = (j % 2 == 0 ? "IC" : "IN") + std::string(" job of ") + std::to_string(j / 2 + 1) +
+        " threads" + options;
+      Check(jobs[j]->Status().state == kJobDone, name + " done");
+      Check(SameAsBatch(*jobs[j], j % 2 == 0 ? ic_batch : in_batch), name);
+    }
+
+    // Step 3: A job cancelled once its first variable is done keeps the rows of the batch
+    std::unique_ptr<SSHICMJob> job = StartIC_SSHICM_Job(d_ic, s, seed, permutation_number, "Sturges", false, 10,
+                                                        0.05, 1, 0, tail);
+    while (job->Status().variables_done == 0 && job->Status().state == kJobRunning) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    job->Cancel();
+    job->Wait();
+    Check(job->Status().variables_done > 0, "cancelled IC job finished a variable" + options);
+    Check(SameAsBatch(*job, ic_batch), "cancelled IC job" + options);
+  }
+  return CheckResult("job");
+}
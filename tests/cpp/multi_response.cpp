@@ -0,0 +1,70 @@
+// Multi-response tests (MultiResponse.h) against the per-target calls they promise to reproduce:
+// each column of the response matrix must get the same row from IC_ / IN_SSHICM_MultiResponse as
+// from IC_ / IN_SSHICM_Batch of that column alone, with and without sequential stopping and tail
+// p-values. One IN target is sparse-coded, so it goes through the recoding of both paths.
+
+#include <random>
+#include <string>
+#include <vector>
+#include <sshicm/sshicm.h>
+#include "check.h"
+
+using namespace sshicm;
+
+int main() {
+  const size_t n = 600;
+  const size_t response_number = 3;
+  const int permutation_number = 199;
+  const unsigned int seed = 11;
+  std::mt19937 rng(4);
+  std::normal_distribution<double> noise(0.0, 1.0);
+
+  // Step 1: Two stratifications, the second coded sparsely, and targets that depend on them to
+  // different degrees, so that some p-values stop early and some fit a tail
+  std::vector<std::vector<int>> s(2, std::vector<int>(n));
+  for (size_t i = 0; i < n; ++i) {
+    s[0][i] = static_cast<int>(rng() % 4) + 1;
+    s[1][i] = static_cast<int>(rng() % 3) * 1000 + 7;
+  }
+  std::vector<double> d_ic(n * response_number);
+  std::vector<int> d_in(n * response_number);
+  for (size_t i = 0; i < n; ++i) {
+    d_ic[i] = 0.5 * s[0][i] + noise(rng);
+    d_ic[n + i] = noise(rng);
+    d_ic[2 * n + i] = 0.001 * s[1][i] + 0.3 * noise(rng);
+    d_in[i] = rng() % 3 == 0 ? static_cast<int>(rng() % 4) + 1 : s[0][i];
+    d_in[n + i] = static_cast<int>(rng() % 5) + 1;
+    d_in[2 * n + i] = rng() % 2 == 0 ? 1 : 1000000000;
+  }
+
+  // Step 2: Compare every target with its own batch call
+  for (size_t v = 0; v < s.size(); ++v) {
+    std::vector<Span<int>> one(1, Span<int>(s[v]));
+    for (bool sequential : {false, true}) {
+      for (bool tail : {false, true}) {
+        std::string options = "s" + std::to_string(v) + (sequential ? " sequential" : "") + (tail ? " tail" : "");
+        for (const std::string bin_method : {"Sturges", "Scott"}) {
+          std::vector<std::vector<double>> rows =
+            IC_SSHICM_MultiResponse(Span<double>(d_ic), response_number, Span<int>(s[v]), seed,
+                                    permutation_number, bin_method, sequential, 10, 0.05, 1, 0, tail);
+          for (size_t t = 0; t < response_number; ++t) {
+            Span<double> target(d_ic.data() + t * n, n);
+            std::vector<double> expected = IC_SSHICM_Batch(target, one, seed, permutation_number, bin_method,
+                                                           sequential, 10, 0.05, 1, 0, tail)[0];
+            Check(SameRow(rows[t], expected), "IC " + bin_method + " target " + std::to_string(t) + " " + options);
+          }
+        }
+        std::vector<std::vector<double>> rows =
+          IN_SSHICM_MultiResponse(Span<int>(d_in), response_number, Span<int>(s[v]), seed, permutation_number,
+                                  sequential, 10, 0.05, 1, 0, tail);
+        for (size_t t = 0; t < response_number; ++t) {
+          Span<int> target(d_in.data() + t * n, n);
+          std::vector<double> expected = IN_SSHICM_Batch(target, one, seed, permutation_number, sequential, 10,
+                                                         0.05, 1, 0, kPValuePermutation, tail)[0];
+          Check(SameRow(rows[t], expected), "IN target " + std::to_string(t) + " " + options);
+        }
+      }
+    }
+  }
+  return CheckResult("multi_response");
+}
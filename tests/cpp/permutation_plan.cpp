@@ -0,0 +1,102 @@
+// Permutation plans (PermutationPlan.h) against runs without a plan: IC_ / IN_SSHICM_Batch and the
+// interaction tests must return the same rows whether their permutations are generated or read from
+// a plan, with and without sequential stopping and tail p-values, and for plans that hold fewer
+// permutations than a run asks for (the rest are generated) as well as more.
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sshicm/sshicm.h>
+#include "check.h"
+
+using namespace sshicm;
+
+// Whether two lists of result rows are identical
+static bool SameRows(const std::vector<std::vector<double>>& a, const std::vector<std::vector<double>>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (!SameRow(a[i], b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  const size_t n = 500;
+  const int permutation_number = 199;
+  const unsigned int seed = 23;
+  std::mt19937 rng(8);
+  std::normal_distribution<double> noise(0.0, 1.0);
+
+  // Step 1: Stratifications and targets that depend on some of them
+  std::vector<std::vector<int>> s(4, std::vector<int>(n));
+  std::vector<double> d_ic(n);
+  std::vector<int> d_in(n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t v = 0; v < s.size(); ++v) {
+      s[v][i] = static_cast<int>(rng() % (v + 2)) + 1;
+    }
+    d_ic[i] = 0.4 * s[0][i] + 0.2 * s[2][i] + noise(rng);
+    d_in[i] = rng() % 3 == 0 ? static_cast<int>(rng() % 4) + 1 : s[1][i];
+  }
+  std::vector<Span<int>> s_list;
+  for (const std::vector<int>& codes : s) {
+    s_list.push_back(Span<int>(codes));
+  }
+
+  // Step 2: Batches with plans shorter than, equal to and longer than the run
+  for (int plan_size : {50, permutation_number, 400}) {
+    PermutationPlan plan(n, seed, plan_size, 1);
+    for (bool sequential : {false, true}) {
+      for (bool tail : {false, true}) {
+        std::string options = "plan of " + std::to_string(plan_size) + (sequential ? " sequential" : "") +
+          (tail ? " tail" : "");
+        Check(SameRows(IC_SSHICM_Batch(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges",
+                                       sequential, 10, 0.05, 1, 0, tail, &plan),
+                       IC_SSHICM_Batch(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges",
+                                       sequential, 10, 0.05, 1, 0, tail)),
+              "IC batch " + options);
+        Check(SameRows(IN_SSHICM_Batch(Span<int>(d_in), s_list, seed, permutation_number, sequential, 10, 0.05,
+                                       1, 0, kPValuePermutation, tail, &plan),
+                       IN_SSHICM_Batch(Span<int>(d_in), s_list, seed, permutation_number, sequential, 10, 0.05,
+                                       1, 0, kPValuePermutation, tail)),
+              "IN batch " + options);
+      }
+    }
+  }
+
+  // Step 3: Interaction tests in batches of two pairs, whose batches all read the same plan
+  PermutationPlan plan(n, seed, permutation_number, 1);
+  for (bool tail : {false, true}) {
+    std::string options = tail ? " tail" : "";
+    Check(SameRows(IC_SSHICM_Interaction(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges", false,
+                                         10, 0.05, 1, 0, tail, &plan, 2),
+                   IC_SSHICM_Interaction(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges", false,
+                                         10, 0.05, 1, 0, tail)),
+          "IC interaction" + options);
+    Check(SameRows(IN_SSHICM_Interaction(Span<int>(d_in), s_list, seed, permutation_number, false, 10, 0.05, 1,
+                                         0, kPValuePermutation, tail, &plan, 2),
+                   IN_SSHICM_Interaction(Span<int>(d_in), s_list, seed, permutation_number, false, 10, 0.05, 1,
+                                         0, kPValuePermutation, tail)),
+          "IN interaction" + options);
+  }
+
+  // Step 4: A plan for another seed or length is refused rather than silently used
+  PermutationPlan other_seed(n, seed + 1, permutation_number, 1);
+  PermutationPlan other_length(n - 1, seed, permutation_number, 1);
+  for (const PermutationPlan* wrong : {&other_seed, &other_length}) {
+    bool refused = false;
+    try {
+      IC_SSHICM_Batch(Span<double>(d_ic), s_list, seed, permutation_number, "Sturges", false, 10, 0.05, 1, 0,
+                      false, wrong);
+    } catch (const std::invalid_argument&) {
+      refused = true;
+    }
+    Check(refused, wrong == &other_seed ? "plan of another seed" : "plan of another length");
+  }
+  return CheckResult("permutation_plan");
+}